@@ -0,0 +1,85 @@
+#ifndef __OLED_FONT_SUBSET_H
+#define __OLED_FONT_SUBSET_H
+
+/* 由 tools/oled_font_subset.py 自动生成，请勿手工修改 */
+/* 字符:  !-./0123456789:ABCDEILMNORSVdeghilmnorstuxy */
+/* 汉字索引: 无 */
+
+#define OLED_SUBSET_CHAR_NUM    44
+#define OLED_SUBSET_HZ_NUM      0
+#define OLED_SUBSET_PACKED      1   // 1: 列压缩，绘制时解压；0: 原始字模
+
+/*已保留的 ASCII 字符（升序，二分查找）*/
+const uint8_t OLED_SubsetChar[44]=
+{
+	0x20,0x21,0x2D,0x2E,0x2F,0x30,0x31,0x32,0x33,0x34,0x35,0x36,0x37,0x38,0x39,0x3A,
+	0x41,0x42,0x43,0x44,0x45,0x49,0x4C,0x4D,0x4E,0x4F,0x52,0x53,0x56,0x64,0x65,0x67,
+	0x68,0x69,0x6C,0x6D,0x6E,0x6F,0x72,0x73,0x74,0x75,0x78,0x79,
+};
+
+/*每个 ASCII 字模在 OLED_SubsetF8x16 中的起始偏移*/
+const uint16_t OLED_SubsetF8x16Offset[44]=
+{
+	0,2,7,16,20,30,44,54,68,82,94,108,121,130,144,157,
+	163,176,191,207,223,239,251,263,276,291,307,323,337,349,362,374,
+	387,400,410,420,435,448,460,474,487,497,510,523,
+};
+
+/*列压缩后的 8x16 字模*/
+const uint8_t OLED_SubsetF8x16[538]=
+{
+	0x00,0x00,0x08,0x18,0xF8,0x33,0x30,0x00,0xFE,0x01,0x01,0x01,0x01,0x01,0x01,0x01,
+	0x00,0x06,0x30,0x30,0xF0,0x1E,0x80,0x60,0x18,0x04,0x60,0x18,0x06,0x01,0x7E,0x7E,
+	0xE0,0x10,0x08,0x08,0x10,0xE0,0x0F,0x10,0x20,0x20,0x10,0x0F,0x0E,0x3E,0x10,0x10,
+	0xF8,0x20,0x20,0x3F,0x20,0x20,0x7E,0x7E,0x70,0x08,0x08,0x08,0x88,0x70,0x30,0x28,
+	0x24,0x22,0x21,0x30,0x7E,0x7E,0x30,0x08,0x88,0x88,0x48,0x30,0x18,0x20,0x20,0x20,
+	0x11,0x0E,0x3C,0x7E,0xC0,0x20,0x10,0xF8,0x07,0x04,0x24,0x24,0x3F,0x24,0x7E,0x7E,
+	0xF8,0x08,0x88,0x88,0x08,0x08,0x19,0x21,0x20,0x20,0x11,0x0E,0x3E,0x7E,0xE0,0x10,
+	0x88,0x88,0x18,0x0F,0x11,0x20,0x20,0x11,0x0E,0x7E,0x08,0x38,0x08,0x08,0xC8,0x38,
+	0x08,0x3F,0x7E,0x7E,0x70,0x88,0x08,0x08,0x88,0x70,0x1C,0x22,0x21,0x21,0x22,0x1C,
+	0x7E,0x7C,0xE0,0x10,0x08,0x08,0x10,0xE0,0x31,0x22,0x22,0x11,0x0F,0x18,0x18,0xC0,
+	0xC0,0x30,0x30,0x1C,0xFF,0xC0,0x38,0xE0,0x20,0x3C,0x23,0x02,0x02,0x27,0x38,0x20,
+	0x3F,0x7F,0x08,0xF8,0x88,0x88,0x88,0x70,0x20,0x3F,0x20,0x20,0x20,0x11,0x0E,0x7F,
+	0x7F,0xC0,0x30,0x08,0x08,0x08,0x08,0x38,0x07,0x18,0x20,0x20,0x20,0x10,0x08,0x7F,
+	0x7F,0x08,0xF8,0x08,0x08,0x08,0x10,0xE0,0x20,0x3F,0x20,0x20,0x20,0x10,0x0F,0x7F,
+	0x7F,0x08,0xF8,0x88,0x88,0xE8,0x08,0x10,0x20,0x3F,0x20,0x20,0x23,0x20,0x18,0x3E,
+	0x3E,0x08,0x08,0xF8,0x08,0x08,0x20,0x20,0x3F,0x20,0x20,0x07,0x7F,0x08,0xF8,0x08,
+	0x20,0x3F,0x20,0x20,0x20,0x20,0x30,0x77,0x6B,0x08,0xF8,0xF8,0xF8,0xF8,0x08,0x20,
+	0x3F,0x3F,0x3F,0x20,0xEF,0x77,0x08,0xF8,0x30,0xC0,0x08,0xF8,0x08,0x20,0x3F,0x20,
+	0x07,0x18,0x3F,0x7F,0x7F,0xE0,0x10,0x08,0x08,0x08,0x10,0xE0,0x0F,0x10,0x20,0x20,
+	0x20,0x10,0x0F,0x7F,0xF7,0x08,0xF8,0x88,0x88,0x88,0x88,0x70,0x20,0x3F,0x20,0x03,
+	0x0C,0x30,0x20,0x7E,0x7E,0x70,0x88,0x08,0x08,0x08,0x38,0x38,0x20,0x21,0x21,0x22,
+	0x1C,0xE7,0x3C,0x08,0x78,0x88,0xC8,0x38,0x08,0x07,0x38,0x0E,0x01,0x78,0xFE,0x80,
+	0x80,0x88,0xF8,0x0E,0x11,0x20,0x20,0x10,0x3F,0x20,0x3C,0x7E,0x80,0x80,0x80,0x80,
+	0x1F,0x22,0x22,0x22,0x22,0x13,0x7C,0x7E,0x80,0x80,0x80,0x80,0x80,0x6B,0x94,0x94,
+	0x94,0x93,0x60,0x3B,0xE7,0x08,0xF8,0x80,0x80,0x80,0x20,0x3F,0x21,0x20,0x3F,0x20,
+	0x0E,0x3E,0x80,0x98,0x98,0x20,0x20,0x3F,0x20,0x20,0x0E,0x3E,0x08,0x08,0xF8,0x20,
+	0x20,0x3F,0x20,0x20,0x7F,0xB7,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x20,0x3F,0x20,
+	0x3F,0x20,0x3F,0x3B,0xE7,0x80,0x80,0x80,0x80,0x80,0x20,0x3F,0x21,0x20,0x3F,0x20,
+	0x3C,0x7E,0x80,0x80,0x80,0x80,0x1F,0x20,0x20,0x20,0x20,0x1F,0x77,0x5F,0x80,0x80,
+	0x80,0x80,0x80,0x80,0x20,0x20,0x3F,0x21,0x20,0x01,0x7C,0x7E,0x80,0x80,0x80,0x80,
+	0x80,0x33,0x24,0x24,0x24,0x24,0x19,0x3E,0x38,0x80,0x80,0xE0,0x80,0x80,0x1F,0x20,
+	0x20,0x63,0xFE,0x80,0x80,0x80,0x80,0x1F,0x20,0x20,0x20,0x10,0x3F,0x20,0x76,0x7E,
+	0x80,0x80,0x80,0x80,0x80,0x20,0x31,0x2E,0x0E,0x31,0x20,0xE7,0x7F,0x80,0x80,0x80,
+	0x80,0x80,0x80,0x80,0x81,0x8E,0x70,0x18,0x06,0x01,
+};
+
+/*已保留的汉字在原 Hzk1 中的索引（升序）*/
+const uint8_t OLED_SubsetHzIndex[1]=
+{
+	0
+};
+
+/*每个汉字字模在 OLED_SubsetHzk1 中的起始偏移*/
+const uint16_t OLED_SubsetHzk1Offset[1]=
+{
+	0
+};
+
+/*列压缩后的 16x16 汉字字模*/
+const uint8_t OLED_SubsetHzk1[1]=
+{
+	0
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include "acq.h"
+#include "dwt.h"
+#include "event_bus.h"
+#include <string.h>
+
+// TIM2 在 APB1(36MHz) 上，APB1 分频不为 1 时定时器时钟加倍，与 SystemCoreClock 相同。
+// 预分频 2，72MHz 时 1ms 为 36000 个计数，不超过 16 位；每个计数等于 2 个 DWT 周期。
+#define ACQ_TIM_PSC        1
+#define ACQ_CYC_PER_COUNT  (ACQ_TIM_PSC + 1)
+
+typedef struct
+{
+    const Sensor_Driver *Drv;
+    uint16_t PeriodMs;
+    uint16_t PhaseMs;
+    uint16_t Countdown;          // 中断中每毫秒减 1，到 0 触发
+    uint8_t  HasTrig;            // LastTrig 有效，可以计算触发间隔
+    uint8_t  Converting;         // 已 Start，等待 Poll 就绪
+    uint8_t  HasSample;
+    volatile uint8_t Pending;    // 中断置 1，主循环完成本次采样后清 0
+    volatile uint32_t TrigTime;  // 本次触发时刻（DWT 周期数），Pending 期间中断不会改写
+    volatile uint32_t TrigMs;    // 本次触发时刻（采集时钟毫秒数）
+    uint32_t LastTrig;           // 上次触发时刻（含丢弃的触发）
+    uint32_t StartTime;          // 本次调用 Start 的时刻
+    uint32_t Seq;                // 已完成的采样序号
+    Sensor_Data Sample;          // 最近一次成功的采样
+    Acq_Stats Stats;             // 时间字段为 DWT 周期数，Acq_GetStats 时换算为 us
+} Acq_Channel;
+
+static Acq_Channel Channels[ACQ_MAX_CHANNELS];
+static uint8_t ChannelNum = 0;
+static volatile uint32_t Ticks = 0;
+
+static void Acq_ClearStats(Acq_Stats *stats)
+{
+    memset(stats, 0, sizeof(Acq_Stats));
+    stats->MinPeriodUs = 0xFFFFFFFF;
+    stats->MinLatencyUs = 0xFFFFFFFF;
+}
+
+/* 配置 TIM2 为 1ms 更新中断，计时由 Acq_Start 开启 */
+void Acq_Init(void)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    memset(Channels, 0, sizeof(Channels));
+    ChannelNum = 0;
+    Ticks = 0;
+    DWT_Init(); // 时间戳和统计都用周期计数器
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+    TIM_TimeBaseStructure.TIM_Prescaler = ACQ_TIM_PSC;
+    TIM_TimeBaseStructure.TIM_Period = SystemCoreClock / ACQ_CYC_PER_COUNT / 1000 - 1;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
+    TIM_ClearFlag(TIM2, TIM_FLAG_Update); // TimeBaseInit 产生的更新事件不算触发
+    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = ACQ_IRQ_PRIORITY;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+/* 添加一个采集通道，周期不足驱动的最小间隔时自动放宽；只能在 Acq_Start 之前调用 */
+u8 Acq_AddChannel(const Sensor_Driver *drv, uint16_t PeriodMs, uint16_t PhaseMs)
+{
+    Acq_Channel *c;
+
+    if (drv == 0 || PeriodMs == 0 || ChannelNum >= ACQ_MAX_CHANNELS) return ACQ_INVALID;
+    if (PeriodMs < drv->MinPeriodMs) PeriodMs = drv->MinPeriodMs;
+
+    c = &Channels[ChannelNum];
+    c->Drv = drv;
+    c->PeriodMs = PeriodMs;
+    c->PhaseMs = PhaseMs;
+    Acq_ClearStats(&c->Stats);
+    return ChannelNum++;
+}
+
+void Acq_Start(void)
+{
+    uint8_t i;
+
+    TIM_Cmd(TIM2, DISABLE);
+    for (i = 0; i < ChannelNum; i++)
+    {
+        Channels[i].Countdown = Channels[i].PhaseMs + 1;
+        Channels[i].HasTrig = 0;
+    }
+    TIM_SetCounter(TIM2, 0);
+    TIM_Cmd(TIM2, ENABLE);
+    Sensor_SetClock(Acq_Now); // Sensor_ReadBlocking 的时间戳与各通道使用同一时钟
+}
+
+void Acq_Stop(void)
+{
+    TIM_Cmd(TIM2, DISABLE);
+    Sensor_SetClock(0);       // 采集时钟停了，恢复 DWT 时钟
+}
+
+/* 采集时钟：只记录触发时刻，不访问传感器 */
+void TIM2_IRQHandler(void)
+{
+    uint32_t now, cnt, period;
+    uint8_t i;
+    Acq_Channel *c;
+
+    // CNT 是更新事件之后经过的计数，扣掉后得到更新事件本身的时刻，
+    // 中断被其他中断或关中断推迟（不超过 1ms）时触发时刻不受影响
+    cnt = TIM2->CNT;
+    now = DWT_CYCCNT_REG - cnt * ACQ_CYC_PER_COUNT;
+    TIM_ClearITPendingBit(TIM2, TIM_IT_Update);
+    Ticks++;
+
+    for (i = 0; i < ChannelNum; i++)
+    {
+        c = &Channels[i];
+        if (--c->Countdown != 0) continue;
+        c->Countdown = c->PeriodMs;
+
+        c->Stats.Triggers++;
+        if (c->HasTrig)
+        {
+            period = now - c->LastTrig;
+            if (period < c->Stats.MinPeriodUs) c->Stats.MinPeriodUs = period;
+            if (period > c->Stats.MaxPeriodUs) c->Stats.MaxPeriodUs = period;
+        }
+        c->LastTrig = now;
+        c->HasTrig = 1;
+
+        if (c->Pending)
+        {
+            c->Stats.Missed++; // 上一次还在转换或还没轮到 Start
+            continue;
+        }
+        c->TrigTime = now;
+        c->TrigMs = Ticks;
+        c->Pending = 1;
+    }
+}
+
+/* 结束本次采样并通知订阅者 */
+static void Acq_Finish(u8 ch, SENSOR_STATUS status)
+{
+    Acq_Channel *c = &Channels[ch];
+    uint32_t ready;
+
+    c->Converting = 0;
+    if (status == SENSOR_OK)
+    {
+        ready = DWT_GetCycles() - c->TrigTime;
+        c->Stats.Samples++;
+        c->Stats.LastReadyUs = ready;
+        if (ready > c->Stats.MaxReadyUs) c->Stats.MaxReadyUs = ready;
+    }
+    else
+    {
+        c->Stats.Errors++;
+    }
+    c->Seq++;
+    c->Pending = 0; // 清除后中断才会登记新的触发
+    EventBus_Publish(EVT_SENSOR_READY, ch, status, c->Seq);
+}
+
+/* 主循环调用：对已触发的通道依次 Start -> Poll -> Read，每次只推进不等待 */
+void Acq_Process(void)
+{
+    SENSOR_STATUS status;
+    Sensor_Data data;
+    uint32_t latency, delay_us;
+    uint8_t i;
+    Acq_Channel *c;
+
+    for (i = 0; i < ChannelNum; i++)
+    {
+        c = &Channels[i];
+        if (!c->Pending) continue;
+
+        if (!c->Converting)
+        {
+            status = c->Drv->Start();
+            if (status == SENSOR_BUSY) continue; // 驱动的最小间隔未到，下次再试
+            if (status != SENSOR_OK)
+            {
+                Acq_Finish(i, status);
+                continue;
+            }
+            c->StartTime = DWT_GetCycles();
+            c->Converting = 1;
+
+            latency = c->StartTime - c->TrigTime;
+            if (latency < c->Stats.MinLatencyUs) c->Stats.MinLatencyUs = latency;
+            if (latency > c->Stats.MaxLatencyUs) c->Stats.MaxLatencyUs = latency;
+        }
+
+        status = c->Drv->Poll();
+        if (status == SENSOR_BUSY)
+        {
+            if (Sensor_Elapsed(c->StartTime, c->Drv->ConvTimeMs + 10)) Acq_Finish(i, SENSOR_ERROR); // 转换超时
+            continue;
+        }
+        if (status == SENSOR_OK)
+        {
+            memset(&data, 0, sizeof(Sensor_Data));
+            status = c->Drv->Read(&data);
+            if (status == SENSOR_OK)
+            {
+                // 触发时刻是精确的整毫秒，加上触发到 Start 的延迟得到实际开始转换的时刻
+                delay_us = DWT_CyclesToUs(c->StartTime - c->TrigTime);
+                data.Timestamp = c->TrigMs + delay_us / 1000;
+                data.TimestampUs = delay_us % 1000;
+                c->Sample = data;
+                c->HasSample = 1;
+            }
+        }
+        Acq_Finish(i, status);
+    }
+}
+
+u8 Acq_GetSample(u8 ch, Sensor_Data *data)
+{
+    if (ch >= ChannelNum || !Channels[ch].HasSample) return 1;
+    *data = Channels[ch].Sample;
+    return 0;
+}
+
+/* 读取统计，触发相关字段由中断更新，拷贝时暂时关中断 */
+void Acq_GetStats(u8 ch, Acq_Stats *stats)
+{
+    if (ch >= ChannelNum)
+    {
+        memset(stats, 0, sizeof(Acq_Stats));
+        return;
+    }
+
+    __disable_irq();
+    *stats = Channels[ch].Stats;
+    __enable_irq();
+
+    if (stats->MinPeriodUs == 0xFFFFFFFF) stats->MinPeriodUs = 0;
+    else stats->MinPeriodUs = DWT_CyclesToUs(stats->MinPeriodUs);
+    if (stats->MinLatencyUs == 0xFFFFFFFF) stats->MinLatencyUs = 0;
+    else stats->MinLatencyUs = DWT_CyclesToUs(stats->MinLatencyUs);
+    stats->MaxPeriodUs = DWT_CyclesToUs(stats->MaxPeriodUs);
+    stats->MaxLatencyUs = DWT_CyclesToUs(stats->MaxLatencyUs);
+    stats->LastReadyUs = DWT_CyclesToUs(stats->LastReadyUs);
+    stats->MaxReadyUs = DWT_CyclesToUs(stats->MaxReadyUs);
+}
+
+void Acq_ResetStats(u8 ch)
+{
+    if (ch >= ChannelNum) return;
+
+    __disable_irq();
+    Acq_ClearStats(&Channels[ch].Stats);
+    Channels[ch].HasTrig = 0;
+    __enable_irq();
+}
+
+uint32_t Acq_Millis(void)
+{
+    return Ticks;
+}
+
+/* 当前时刻：Ticks 加上 TIM2 计数器里不足 1ms 的部分 */
+void Acq_Now(uint32_t *ms, uint16_t *us)
+{
+    uint32_t ticks, cnt;
+
+    __disable_irq();
+    ticks = Ticks;
+    cnt = TIM2->CNT;
+    // 计数器已回绕但中断还没来得及处理（关中断期间），补上这 1ms
+    if (TIM_GetFlagStatus(TIM2, TIM_FLAG_Update) != RESET && cnt < TIM2->ARR / 2) ticks++;
+    __enable_irq();
+
+    *ms = ticks;
+    *us = (uint16_t)(cnt * ACQ_CYC_PER_COUNT / DWT_CYCLES_PER_US);
+}
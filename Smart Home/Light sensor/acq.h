@@ -0,0 +1,49 @@
+#ifndef __ACQ_H
+#define __ACQ_H
+
+#include "stm32f10x.h"
+#include "sensor.h"
+
+// 定时器驱动的多传感器同步采集
+// TIM2 每 1ms 产生一次更新中断作为采集时钟，各通道按固定周期和相位触发。
+// 中断里只记录触发时刻并置位，Start/Poll/Read 由主循环中的 Acq_Process() 按通道流水进行：
+// 各通道的转换窗口互相重叠，某个传感器读得慢只会推迟其他通道的 Start，不会推迟触发；
+// 上一次还没完成时又到了触发点，记为一次 Missed。
+// 完成一次采样后发布 EVT_SENSOR_READY：Arg8=通道号，Arg16=状态，Data=采样序号，
+// 数据用 Acq_GetSample() 读取。时间戳以触发时刻（即 TIM2 更新事件，恰好是整毫秒）为基准，
+// 加上触发到实际调用 Start 的延迟，Timestamp 为毫秒、TimestampUs 为毫秒以下的微秒。
+
+/***************根据自己需求更改****************/
+#define ACQ_MAX_CHANNELS   4
+#define ACQ_IRQ_PRIORITY   0      // 抢占优先级（NVIC_PriorityGroup_2 下 0~3），高于 USART1(1)，保证触发时刻不被推迟
+/*********************END**********************/
+
+#define ACQ_INVALID        0xFF   // Acq_AddChannel 失败时的返回值
+
+// 单个通道的统计，时间单位 us
+typedef struct
+{
+    uint32_t Triggers;      // 触发次数（含丢弃的）
+    uint32_t Samples;       // 成功采样次数
+    uint32_t Errors;        // Start/Poll/Read 失败或转换超时
+    uint32_t Missed;        // 触发时上一次采样未完成而丢弃的触发
+    uint32_t MinPeriodUs;   // 相邻两次触发的实际间隔
+    uint32_t MaxPeriodUs;
+    uint32_t MinLatencyUs;  // 触发到 Start 的延迟，最大最小之差即采样时刻抖动
+    uint32_t MaxLatencyUs;
+    uint32_t LastReadyUs;   // 触发到数据就绪
+    uint32_t MaxReadyUs;
+} Acq_Stats;
+
+void Acq_Init(void);                          // 配置 TIM2，在 Sensor_Register 之后调用
+u8 Acq_AddChannel(const Sensor_Driver *drv, uint16_t PeriodMs, uint16_t PhaseMs); // 返回通道号，失败返回 ACQ_INVALID
+void Acq_Start(void);                         // 开始计时，各通道在 PhaseMs 后首次触发；同时作为 Sensor_Timestamp 的时钟
+void Acq_Stop(void);
+void Acq_Process(void);                       // 主循环调用，推进各通道的采样流程
+u8 Acq_GetSample(u8 ch, Sensor_Data *data);   // 最近一次成功的采样，返回0:成功 1:还没有数据
+void Acq_GetStats(u8 ch, Acq_Stats *stats);
+void Acq_ResetStats(u8 ch);
+uint32_t Acq_Millis(void);                    // 采集时钟的毫秒计数
+void Acq_Now(uint32_t *ms, uint16_t *us);     // 采集时钟的当前时刻，精确到微秒；Acq_Start 之前为 0
+
+#endif
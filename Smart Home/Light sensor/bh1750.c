@@ -2,33 +2,68 @@
 #include "delay.h" 
 #include "stm32f10x_i2c.h" 
 
+// I2C 等待超时的循环次数，400KHz 下一个字节约 25us，这里约留 5ms 余量
+#define I2C_TIMEOUT  0x8000
+
+// -----------------------------------------------------------
+// 辅助函数：等待 I2C 事件，器件无应答(AF)或超时返回 BH1750_ERROR
+// -----------------------------------------------------------
+static BH1750_STATUS I2C_WaitEvent(I2C_TypeDef* I2Cx, uint32_t event)
+{
+    uint32_t timeout = I2C_TIMEOUT;
+    while(!I2C_CheckEvent(I2Cx, event))
+    {
+        if (I2C_GetFlagStatus(I2Cx, I2C_FLAG_AF) || --timeout == 0) return BH1750_ERROR;
+    }
+    return BH1750_OK;
+}
+
+// -----------------------------------------------------------
+// 辅助函数：传输失败时清除应答失败标志并发送停止条件释放总线
+// -----------------------------------------------------------
+static BH1750_STATUS I2C_Abort(I2C_TypeDef* I2Cx)
+{
+    uint32_t timeout = I2C_TIMEOUT;
+
+    I2C_ClearFlag(I2Cx, I2C_FLAG_AF);
+    I2C_GenerateSTOP(I2Cx, ENABLE);
+    I2C_AcknowledgeConfig(I2Cx, ENABLE);
+    while(I2C_GetFlagStatus(I2Cx, I2C_FLAG_BUSY) && --timeout);
+    return BH1750_ERROR;
+}
+
 // -----------------------------------------------------------
 // 辅助函数：I2C 写字节 (SPL )
 // -----------------------------------------------------------
 BH1750_STATUS I2C_WriteBytes_SPL(I2C_TypeDef* I2Cx, uint8_t DeviceAddr, uint8_t* pBuffer, uint16_t NumByteToWrite)
 {
+    uint32_t timeout = I2C_TIMEOUT;
+
     // 1. 发送起始条件
     I2C_GenerateSTART(I2Cx, ENABLE);
     // 等待EV5：SB=1, MSL=1, BUSY=1
-    while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_MODE_SELECT));
+    if (I2C_WaitEvent(I2Cx, I2C_EVENT_MASTER_MODE_SELECT) != BH1750_OK) return I2C_Abort(I2Cx);
 
     // 2. 发送设备地址和写方向
     I2C_Send7bitAddress(I2Cx, DeviceAddr, I2C_Direction_Transmitter);
-    // 等待EV6：ADDR=1, MSL=1, BUSY=1, TXE=1, TRA=1
-    while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
+    // 等待EV6：ADDR=1, MSL=1, BUSY=1, TXE=1, TRA=1；器件不在时地址无应答
+    if (I2C_WaitEvent(I2Cx, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED) != BH1750_OK) return I2C_Abort(I2Cx);
 
     // 3. 发送数据
     while(NumByteToWrite--)
     {
         I2C_SendData(I2Cx, *pBuffer++);
         // 等待EV8：TXE=1, BUSY=1, TRA=1, MSL=1
-        while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_TRANSMITTING));
+        if (I2C_WaitEvent(I2Cx, I2C_EVENT_MASTER_BYTE_TRANSMITTING) != BH1750_OK) return I2C_Abort(I2Cx);
     }
 
     // 4. 发送停止条件
     I2C_GenerateSTOP(I2Cx, ENABLE);
     // 等待总线空闲
-    while(I2C_GetFlagStatus(I2Cx, I2C_FLAG_BUSY));
+    while(I2C_GetFlagStatus(I2Cx, I2C_FLAG_BUSY))
+    {
+        if (--timeout == 0) return BH1750_ERROR;
+    }
 
     return BH1750_OK;
 }
@@ -38,13 +73,15 @@ BH1750_STATUS I2C_WriteBytes_SPL(I2C_TypeDef* I2Cx, uint8_t DeviceAddr, uint8_t*
 // -----------------------------------------------------------
 BH1750_STATUS I2C_ReadBytes_SPL(I2C_TypeDef* I2Cx, uint8_t DeviceAddr, uint8_t* pBuffer, uint16_t NumByteToRead)
 {
+    uint32_t timeout = I2C_TIMEOUT;
+
     // 1. 发送起始条件
     I2C_GenerateSTART(I2Cx, ENABLE);
-    while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_MODE_SELECT));
+    if (I2C_WaitEvent(I2Cx, I2C_EVENT_MASTER_MODE_SELECT) != BH1750_OK) return I2C_Abort(I2Cx);
 
     // 2. 发送设备地址和读方向
     I2C_Send7bitAddress(I2Cx, DeviceAddr | 0x01, I2C_Direction_Receiver); // | 0x01 表示读
-    while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED));
+    if (I2C_WaitEvent(I2Cx, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED) != BH1750_OK) return I2C_Abort(I2Cx);
 
     // 3. 读取数据
     while(NumByteToRead)
@@ -56,13 +93,16 @@ BH1750_STATUS I2C_ReadBytes_SPL(I2C_TypeDef* I2Cx, uint8_t DeviceAddr, uint8_t*
         }
 
         // 等待EV7：RXNE=1
-        while(!I2C_CheckEvent(I2Cx, I2C_EVENT_MASTER_BYTE_RECEIVED));
+        if (I2C_WaitEvent(I2Cx, I2C_EVENT_MASTER_BYTE_RECEIVED) != BH1750_OK) return I2C_Abort(I2Cx);
         *pBuffer++ = I2C_ReceiveData(I2Cx); // 读取数据
         NumByteToRead--;
     }
 
     I2C_AcknowledgeConfig(I2Cx, ENABLE); // 恢复ACK使能
-    while(I2C_GetFlagStatus(I2Cx, I2C_FLAG_BUSY)); // 等待总线空闲
+    while(I2C_GetFlagStatus(I2Cx, I2C_FLAG_BUSY)) // 等待总线空闲
+    {
+        if (--timeout == 0) return BH1750_ERROR;
+    }
 
     return BH1750_OK;
 }
@@ -1,5 +1,10 @@
 #include "dht11.h"
 #include "delay.h"
+#include "dwt.h"
+#include "ramfunc.h"
+
+// 解码时直接读 IDR，不调用 Flash 中的 GPIO_ReadInputDataBit
+#define DHT11_DQ_IN   (DHT11_GPIO_PORT->IDR & DHT11_GPIO_PIN)
       
 
 //复位DHT11
@@ -36,29 +41,27 @@ u8 DHT11_Check(void)
 }
 
 //从DHT11读取一个位
+//用 DWT 周期计数器测量高电平宽度：0 为 26~28us，1 为 70us，以 40us 为界
+//不依赖 delay_us 和代码执行速度，每段等待最多 100us
 //返回值：1/0
-u8 DHT11_Read_Bit(void) 			 
+RAMFUNC u8 DHT11_Read_Bit(void) 			 
 {
- 	u8 retry=0;
-	while(GPIO_ReadInputDataBit(DHT11_GPIO_PORT,DHT11_GPIO_PIN)&&retry<100)//等待变为低电平
-	{
-		retry++;
-		delay_us(1);
-	}
-	retry=0;
-	while(!GPIO_ReadInputDataBit(DHT11_GPIO_PORT,DHT11_GPIO_PIN)&&retry<100)//等待变高电平
-	{
-		retry++;
-		delay_us(1);
-	}
-	delay_us(40);//等待40us
-	if(GPIO_ReadInputDataBit(DHT11_GPIO_PORT,DHT11_GPIO_PIN))return 1;
+	uint32_t start;
+	uint32_t us = DWT_CYCLES_PER_US;
+	uint32_t timeout = 100 * us;
+	start = DWT_CYCCNT_REG;
+	while (DHT11_DQ_IN && (DWT_CYCCNT_REG - start) < timeout);//等待变为低电平
+	start = DWT_CYCCNT_REG;
+	while (!DHT11_DQ_IN && (DWT_CYCCNT_REG - start) < timeout);//等待变高电平
+	start = DWT_CYCCNT_REG;
+	while (DHT11_DQ_IN && (DWT_CYCCNT_REG - start) < timeout);//测量高电平宽度
+	if ((DWT_CYCCNT_REG - start) > 40 * us) return 1;
 	else return 0;		   
 }
 
 //从DHT11读取一个字节
 //返回值：读到的数据
-u8 DHT11_Read_Byte(void)    
+RAMFUNC u8 DHT11_Read_Byte(void)    
 {        
 	u8 i,dat;
 	dat=0;
@@ -107,6 +110,7 @@ u8 DHT11_Init(void)
  	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
  	GPIO_Init(DHT11_GPIO_PORT, &GPIO_InitStructure);				 //初始化IO口
  	GPIO_SetBits(DHT11_GPIO_PORT,DHT11_GPIO_PIN);						 //PG11 输出高
+	DWT_Init();                                          //DHT11_Read_Bit 依赖周期计数器
 			    
 	DHT11_Rst();  //复位DHT11
 	return DHT11_Check();//等待DHT11的回应
@@ -0,0 +1,24 @@
+#include "dwt.h"
+
+/* 使能 DWT 周期计数器，多次调用无副作用 */
+void DWT_Init(void)
+{
+    CoreDebug->DEMCR |= DEMCR_TRCENA;          // 打开 DWT/ITM 跟踪模块
+    if (!(DWT_CTRL_REG & DWT_CTRL_CYCCNTENA))
+    {
+        DWT_CYCCNT_REG = 0;
+        DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA;    // 启动周期计数
+    }
+}
+
+/* 读取当前周期计数 */
+uint32_t DWT_GetCycles(void)
+{
+    return DWT_CYCCNT_REG;
+}
+
+/* 周期数换算为微秒 */
+uint32_t DWT_CyclesToUs(uint32_t cycles)
+{
+    return cycles / DWT_CYCLES_PER_US;
+}
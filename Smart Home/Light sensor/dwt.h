@@ -0,0 +1,19 @@
+#ifndef __DWT_H
+#define __DWT_H
+
+#include "stm32f10x.h"
+
+// Cortex-M3 DWT 周期计数器（CMSIS V1.30 的 core_cm3.h 未定义 DWT 结构体，直接按地址访问）
+// 72MHz 下每个计数为 13.9ns，约 59.6s 回绕一次，做差时用无符号减法即可
+#define DWT_CTRL_REG        (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT_REG      (*(volatile uint32_t *)0xE0001004)
+#define DWT_CTRL_CYCCNTENA  (1UL << 0)
+#define DEMCR_TRCENA        (1UL << 24)
+
+#define DWT_CYCLES_PER_US   (SystemCoreClock / 1000000)
+
+void DWT_Init(void);                       // 使能周期计数器
+uint32_t DWT_GetCycles(void);              // 读取当前周期计数
+uint32_t DWT_CyclesToUs(uint32_t cycles);  // 周期数换算为微秒
+
+#endif
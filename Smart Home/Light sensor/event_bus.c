@@ -0,0 +1,80 @@
+#include "event_bus.h"
+#include <string.h>
+
+static Event EventBuf[EVT_NUM][EVENT_QUEUE_DEPTH];
+static SPSC_Queue EventQueue[EVT_NUM];
+static Event_Handler Subscribers[EVT_NUM][EVENT_MAX_SUBSCRIBERS];
+static uint8_t SubscriberNum[EVT_NUM];
+static uint32_t DispatchCount[EVT_NUM];
+
+/* 初始化所有事件通道，需在使能相关中断之前调用 */
+void EventBus_Init(void)
+{
+    uint8_t i;
+    for (i = 0; i < EVT_NUM; i++)
+    {
+        SPSC_Init(&EventQueue[i], EventBuf[i], sizeof(Event), EVENT_QUEUE_DEPTH);
+        SubscriberNum[i] = 0;
+        DispatchCount[i] = 0;
+    }
+}
+
+/* 订阅事件，只能在主循环中调用 */
+u8 EventBus_Subscribe(EVENT_ID id, Event_Handler handler)
+{
+    if (id >= EVT_NUM || SubscriberNum[id] >= EVENT_MAX_SUBSCRIBERS) return 1;
+    Subscribers[id][SubscriberNum[id]++] = handler;
+    return 0;
+}
+
+/* 发布事件，可在中断中调用；同一通道只能有一个生产者 */
+u8 EventBus_Publish(EVENT_ID id, uint8_t arg8, uint16_t arg16, uint32_t data)
+{
+    Event evt;
+    if (id >= EVT_NUM) return 1;
+    evt.Id = id;
+    evt.Arg8 = arg8;
+    evt.Arg16 = arg16;
+    evt.Data = data;
+    return SPSC_Push(&EventQueue[id], &evt);
+}
+
+/* 取出所有积压事件并依次调用订阅者，在主循环中调用 */
+uint16_t EventBus_Dispatch(void)
+{
+    Event evt;
+    uint16_t count = 0;
+    uint8_t i, j;
+
+    for (i = 0; i < EVT_NUM; i++)
+    {
+        while (SPSC_Pop(&EventQueue[i], &evt) == 0)
+        {
+            for (j = 0; j < SubscriberNum[i]; j++)
+            {
+                Subscribers[i][j](&evt);
+            }
+            DispatchCount[i]++;
+            count++;
+        }
+    }
+    return count;
+}
+
+/* 读取通道统计信息 */
+void EventBus_GetStats(EVENT_ID id, Event_Stats *stats)
+{
+    SPSC_Queue *q;
+
+    if (id >= EVT_NUM)
+    {
+        memset(stats, 0, sizeof(Event_Stats));
+        return;
+    }
+    q = &EventQueue[id];
+    stats->Depth = SPSC_Count(q);
+    stats->HighWater = q->HighWater;
+    stats->Published = q->Pushed;
+    stats->Overflow = q->Overflow;
+    stats->Dispatched = DispatchCount[id];
+}
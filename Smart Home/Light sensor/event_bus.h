@@ -0,0 +1,49 @@
+#ifndef __EVENT_BUS_H
+#define __EVENT_BUS_H
+
+#include "stm32f10x.h"
+#include "spsc_queue.h"
+
+// 中断 -> 主循环的发布/订阅事件总线
+// 每个事件通道对应一个 SPSC 队列，同一通道只能有一个生产者（一个中断或主循环本身），
+// 不同优先级的中断请发布到不同通道。订阅和分发只在主循环中进行。
+
+/***************根据自己需求更改****************/
+#define EVENT_QUEUE_DEPTH      8   // 每个通道的队列深度，2 的幂
+#define EVENT_MAX_SUBSCRIBERS  4   // 每个通道的最大订阅者数
+/*********************END**********************/
+
+typedef enum
+{
+    EVT_SENSOR_READY = 0, // 传感器数据就绪，Arg8=采集通道号，Arg16=状态(0 正常)，Data=采样序号（数据见 acq.h）
+    EVT_KEY,              // 按键，Arg8=按键编号
+    EVT_UART_RX,          // RS-485 收到一帧 CRC 正确的数据（USART1 中断发布），Arg8=帧地址，Arg16=命令，Data=数据长度
+    EVT_NUM
+} EVENT_ID;
+
+typedef struct
+{
+    uint8_t  Id;     // EVENT_ID
+    uint8_t  Arg8;
+    uint16_t Arg16;
+    uint32_t Data;
+} Event;
+
+typedef void (*Event_Handler)(const Event *evt);
+
+typedef struct
+{
+    uint16_t Depth;      // 当前积压
+    uint16_t HighWater;  // 历史最大积压
+    uint32_t Published;  // 成功发布次数
+    uint32_t Overflow;   // 队列满丢弃次数
+    uint32_t Dispatched; // 已分发次数
+} Event_Stats;
+
+void EventBus_Init(void);
+u8 EventBus_Subscribe(EVENT_ID id, Event_Handler handler);  // 返回0:成功 1:订阅者已满
+u8 EventBus_Publish(EVENT_ID id, uint8_t arg8, uint16_t arg16, uint32_t data); // 返回0:成功 1:队列满
+uint16_t EventBus_Dispatch(void);                           // 主循环调用，返回本次分发的事件数
+void EventBus_GetStats(EVENT_ID id, Event_Stats *stats);
+
+#endif
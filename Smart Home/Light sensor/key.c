@@ -1,5 +1,6 @@
 #include "key.h"
-#include "delay.h" // 需要用到延时函数进行消抖
+
+#define KEY_DEBOUNCE_COUNT  20 // 消抖次数，每 1ms 调用一次时即 20ms
 
 /**
  * @brief  按键GPIO初始化
@@ -44,53 +45,45 @@ void Key_Init(void)
 }
 
 /**
- * @brief  获取按键值（带简单消抖）
+ * @brief  读取当前按下的按键（不消抖）
  * @param  无
- * @retval 按下的按键编号（1-3），无按键按下返回0
+ * @retval 按下的按键编号（1-3），多个键同时按下时编号小的优先，无按键按下返回0
+ */
+static uint8_t Key_Read(void)
+{
+    // GPIO_ReadInputDataBit 读到低电平 (Bit_RESET) 表示按键被按下
+    if (GPIO_ReadInputDataBit(KEY1_GPIO_PORT, KEY1_GPIO_PIN) == Bit_RESET) return 1; // KEY1 (PA15 - 模式切换键)
+    if (GPIO_ReadInputDataBit(KEY2_GPIO_PORT, KEY2_GPIO_PIN) == Bit_RESET) return 2; // KEY2 (PA12 - 增加阈值键)
+    if (GPIO_ReadInputDataBit(KEY3_GPIO_PORT, KEY3_GPIO_PIN) == Bit_RESET) return 3; // KEY3 (PA11 - 减少阈值键)
+    return 0;
+}
+
+/**
+ * @brief  获取按键值（计数消抖，不阻塞）
+ * @note   每 1ms 调用一次：连续 KEY_DEBOUNCE_COUNT 次读到相同状态才认为按键状态改变，
+ *         按下时只返回一次按键编号，长按和松开都返回 0。
+ *         不再用 delay_ms 消抖、也不在函数里等待松开，按住按键时主循环照常运行
+ * @param  无
+ * @retval 新按下的按键编号（1-3），没有新按下的按键返回0
  */
 uint8_t Key_GetNum(void)
 {
-    uint8_t KeyNum = 0; // 定义并初始化按键编号变量，0表示没有按键按下
+    static uint8_t Stable = 0; // 消抖后的按键状态
+    static uint8_t Last = 0;   // 上次读到的按键
+    static uint8_t Count = 0;  // Last 已连续出现的次数
+    uint8_t Now = Key_Read();
 
-    // 检测KEY1 (PA15 - 模式切换键)
-    // GPIO_ReadInputDataBit 函数用于读取指定GPIO引脚的输入状态
-    // 如果读取到低电平 (Bit_RESET)，表示按键被按下
-    if (GPIO_ReadInputDataBit(KEY1_GPIO_PORT, KEY1_GPIO_PIN) == Bit_RESET) // Bit_RESET表示低电平
-    {
-        delay_ms(20); // 延时20ms进行消抖，等待按键机械抖动结束
-        // 再次确认按键状态，防止是抖动或干扰引起的误判
-        if (GPIO_ReadInputDataBit(KEY1_GPIO_PORT, KEY1_GPIO_PIN) == Bit_RESET) // 再次确认是否真的按下
-        {
-            KeyNum = 1; // 如果确认按下，则将按键编号设置为1
-        }
-        // 等待按键松开。这个while循环会一直执行，直到按键被释放（引脚恢复高电平）
-        // 这样可以确保一次按键只触发一次有效的检测，防止按键长按导致多次触发
-        while (GPIO_ReadInputDataBit(KEY1_GPIO_PORT, KEY1_GPIO_PIN) == Bit_RESET); // 等待按键松开
-        delay_ms(20); // 松开延时消抖，等待按键松开后的机械抖动结束
-    }
-    // 检测KEY2 (PA12 - 增加阈值键)
-    // 使用else if，确保每次只检测一个按键，并且在多个按键同时按下时，优先检测到第一个按键
-    else if (GPIO_ReadInputDataBit(KEY2_GPIO_PORT, KEY2_GPIO_PIN) == Bit_RESET)
+    if (Now != Last)
     {
-        delay_ms(20); // 延时消抖
-        if (GPIO_ReadInputDataBit(KEY2_GPIO_PORT, KEY2_GPIO_PIN) == Bit_RESET)
-        {
-            KeyNum = 2; // 设置按键编号为2
-        }
-        while (GPIO_ReadInputDataBit(KEY2_GPIO_PORT, KEY2_GPIO_PIN) == Bit_RESET); // 等待按键松开
-        delay_ms(20); // 松开延时消抖
+        Last = Now;  // 状态变了（或抖动），重新计数
+        Count = 0;
     }
-    // 检测KEY3 (PA11 - 减少阈值键)
-    else if (GPIO_ReadInputDataBit(KEY3_GPIO_PORT, KEY3_GPIO_PIN) == Bit_RESET)
+    else if (Count < KEY_DEBOUNCE_COUNT)
     {
-        delay_ms(20); // 延时消抖
-        if (GPIO_ReadInputDataBit(KEY3_GPIO_PORT, KEY3_GPIO_PIN) == Bit_RESET)
-        {
-            KeyNum = 3; // 设置按键编号为3
-        }
-        while (GPIO_ReadInputDataBit(KEY3_GPIO_PORT, KEY3_GPIO_PIN) == Bit_RESET); // 等待按键松开
-        delay_ms(20); // 松开延时消抖
+        Count++;
     }
 
-    return KeyNum; // 返回检测到的按键编号，如果无按键按下则返回0
+    if (Count < KEY_DEBOUNCE_COUNT || Now == Stable) return 0;
+    Stable = Now;
+    return Now; // 松开时 Now 为 0
 }
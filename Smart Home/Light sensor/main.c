@@ -3,6 +3,14 @@
 #include "bh1750.h"        // BH1750 驱动头文件
 #include "stdio.h"         // 用于 sprintf 格式化字符串
 #include "delay.h"         // 延时函数头文件
+#include "event_bus.h"     // 中断/主循环事件总线
+#include "sensor.h"        // 通用传感器接口
+#include "oled_power.h"    // OLED 功耗管理
+#include "key.h"           // 按键（唤醒屏幕）
+#include "rs485.h"         // RS-485 多机组网
+#include "ramfunc.h"       // SRAM 执行及时序测量
+#include "acq.h"           // 定时器驱动的同步采集
+#include "led.h"           // 总线活动指示
 
 // 引入 SPL 库外设头文件
 #include "stm32f10x_rcc.h"   // 时钟控制
@@ -12,14 +20,30 @@
 
 /* USER CODE BEGIN PV */
 // 私有变量
-uint16_t lux_value = 0;    // 存储光照度值
+Sensor_Data sensor_data;   // 存储传感器读数
+const Sensor_Driver *light_sensor; // 当前使用的光照传感器
+Sensor_Data adc_data;      // 供电电压、芯片温度等 ADC 读数
+Sensor_Data dht_data;      // 温湿度读数（接了 DHT11 时才有）
+u8 light_ch = ACQ_INVALID; // 各传感器的采集通道号（EVT_SENSOR_READY 的 Arg8）
+u8 adc_ch = ACQ_INVALID;
+u8 dht_ch = ACQ_INVALID;
+char vdd_str[20] = {0};    // 格式化供电电压字符串
 char lux_str[20] = {0};    // 格式化光照度字符串
+uint32_t last_tick = 0;    // 上次 1ms 节拍处理时的采集时钟毫秒数
+
+// RS-485 组网：不定义为单机运行；0 为主机，1~32 为从机地址
+// #define RS485_NODE_ADDR   1
+#define RS485_NODE_COUNT  8        // 主机轮询的从机数量
+#define RS485_POLL_MS     500      // 主机轮询间隔
+#if defined(RS485_NODE_ADDR) && RS485_NODE_ADDR == 0
+Sensor_Data node_table[RS485_NODE_COUNT]; // 各从机最新读数
+char node_str[20] = {0};
+uint8_t node_online = 0;                  // 最近一个轮询周期在线的从机数
+uint32_t last_poll = 0;
+#endif
 /* USER CODE END PV */
 
 /* USER CODE BEGIN 0 */
-// 定义 BH1750 使用的硬件 I2C 外设
-#define BH1750_I2C_PERIPH I2C1  
-
 // OLED 引脚宏（根据电路：PB14=SCL，PB15=SDA ）
 #ifndef OLED_SCL_GPIO_PIN
 #define OLED_SCL_GPIO_PORT    GPIOB
@@ -27,6 +51,19 @@ char lux_str[20] = {0};    // 格式化光照度字符串
 #define OLED_SDA_GPIO_PORT    GPIOB
 #define OLED_SDA_GPIO_PIN     GPIO_Pin_15
 #endif
+
+// 采样周期和相位（ms）：错开相位，避免几个通道在同一毫秒触发、互相推迟 Start
+#define LIGHT_PERIOD_MS   500
+#define LIGHT_PHASE_MS    0
+#define ADC_PERIOD_MS     500
+#define ADC_PHASE_MS      250
+#define DHT_PERIOD_MS     2000
+#define DHT_PHASE_MS      100
+
+// 定义后开机先显示 OLED 时序测量结果（周期数，最小-最大）：OLED 为实际 I2C 写命令耗时，
+// I2C 为去掉保持等待后的同一段代码；
+// 分别在定义/不定义 RAMFUNC_ENABLE 时各运行一次即可对比 SRAM 与 Flash 执行的差异
+// #define RAMFUNC_BENCH
 /* USER CODE END 0 */
 // ============================================================================
 // 函数名称：Error_Handler
@@ -124,43 +161,166 @@ void MX_I2C1_Init(void)
     I2C_Cmd(I2C1, ENABLE);           // 使能 I2C1 外设
 }
 
+// ============================================================================
+// 函数名称：Display_OnSensorReady
+// 功能描述：EVT_SENSOR_READY 订阅者，刷新 OLED 显示
+// ============================================================================
+void Display_OnSensorReady(const Event *evt)
+{
+    if (!OLEDPower_IsOn()) return; // 熄屏期间不重画，显存保留原内容，点亮后随下一次采样更新
+
+    if (evt->Arg8 == adc_ch)
+    {
+#if !(defined(RS485_NODE_ADDR) && RS485_NODE_ADDR == 0)
+        if (evt->Arg16 == SENSOR_OK && Acq_GetSample(adc_ch, &adc_data) == 0)
+        {
+            sprintf(vdd_str, "VDD: %d.%d mV", adc_data.Vdd / 10, adc_data.Vdd % 10); // 单位 0.1mV
+            OLED_UpdateLine(4, vdd_str); // 第 4 行显示供电电压
+        }
+#endif
+        return;
+    }
+    if (evt->Arg8 != light_ch) return;
+
+    if (evt->Arg16 == SENSOR_OK && Acq_GetSample(light_ch, &sensor_data) == 0)
+    {
+        OLEDPower_Update(sensor_data.Lux); // 按光照度调整对比度
+
+        // 格式化光照度字符串（如 "Lux: 123 lx" ）
+        sprintf(lux_str, "Lux: %d lx", (int)sensor_data.Lux);
+
+        // 不再清屏重画：整屏清除约 75ms，会把下一个通道的 Start 推迟同样长的时间，
+        // 各行只重画变化的字符；第 4 行由电压通道或主机轮询单独更新
+        OLED_UpdateLine(1, "Light Sensor"); // 第 1 行显示标题 
+        OLED_UpdateLine(2, lux_str);        // 第 2 行显示光照度值
+        OLED_UpdateLine(3, "By: LiLu 15"); 
+    }
+    else
+    {
+        OLED_UpdateLine(1, "Sensor Error!"); // 读取失败提示
+        OLED_UpdateLine(2, "");              // 清掉上次的读数
+        OLED_UpdateLine(3, "By: LiLu 15");   // 错误信息时也显示名字
+    }
+}
+
+#ifdef RS485_NODE_ADDR
+// ============================================================================
+// 函数名称：Bus_OnUartRx
+// 功能描述：EVT_UART_RX 订阅者，收到与本机有关的帧时翻转 LED（主机为所有应答，从机为发给自己的请求）
+// ============================================================================
+void Bus_OnUartRx(const Event *evt)
+{
+    if (RS485_NODE_ADDR == 0 || evt->Arg8 == RS485_NODE_ADDR) LED_Toggle();
+}
+#endif
+
+#if defined(RS485_NODE_ADDR) && RS485_NODE_ADDR != 0
+// ============================================================================
+// 函数名称：Node_OnSensorReady
+// 功能描述：从机把光照度和温湿度合并成一份应答数据，供主机轮询
+// ============================================================================
+void Node_OnSensorReady(const Event *evt)
+{
+    Sensor_Data sample;
+
+    if (evt->Arg8 != light_ch && evt->Arg8 != dht_ch) return;
+    if (evt->Arg16 != SENSOR_OK || Acq_GetSample(light_ch, &sample) != 0) return;
+    if (Acq_GetSample(dht_ch, &dht_data) == 0)
+    {
+        sample.Temp = dht_data.Temp;
+        sample.Humi = dht_data.Humi;
+        sample.Valid |= dht_data.Valid;
+    }
+    RS485_SlaveSetSample(&sample);
+}
+#endif
+
 int main(void)
 {
     /* 1. 系统初始化 */
     SystemClock_Config(); // 配置系统时钟为 72MHz
+    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2); // 2 位抢占优先级 + 2 位子优先级，只设置一次
     MX_GPIO_Init();       // 初始化 GPIO（I2C、OLED 引脚）
     MX_I2C1_Init();       // 初始化硬件 I2C1（BH1750 用）
     delay_init(72);       // 延时函数初始化（参数为系统时钟 72MHz）
     OLED_Init();          // 初始化 OLED 显示屏
     OLED_Clear();         // 清屏
+    Key_Init();           // 初始化按键
 
-    /* 2. 初始化 BH1750：连续高分辨率模式 */
-    if (BH1750_Init(BH1750_I2C_PERIPH, BH1750_MODE_CONTINUOUS_HIGH_RES_MODE) != BH1750_OK)
+#ifdef RAMFUNC_BENCH
+    {
+        RamFunc_Timing oled_timing, i2c_timing;
+        char bench_str[20];
+        RamFunc_MeasureOLED(&i2c_timing, 0);   // 不含保持等待，只看代码本身
+        OLED_Init();                           // 无等待的时钟太快，屏幕可能收到错误命令，重新初始化
+        RamFunc_MeasureOLED(&oled_timing, OLED_I2C_HOLD_CYCLES);
+        sprintf(bench_str, "OLED %d-%d", (int)oled_timing.Min, (int)oled_timing.Max);
+        OLED_ShowString(1, 1, bench_str);
+        sprintf(bench_str, "I2C %d-%d", (int)i2c_timing.Min, (int)i2c_timing.Max);
+        OLED_ShowString(2, 1, bench_str);
+        sprintf(bench_str, "RAM %d B", (int)RamFunc_CodeSize());
+        OLED_ShowString(3, 1, bench_str);
+        delay_ms(1800);
+        delay_ms(1800);
+        OLED_Clear();
+    }
+#endif
+
+    /* 2. 注册传感器：应用只按能力查找，换传感器只改这里 */
+    if (Sensor_Register(&Sensor_BH1750) != SENSOR_OK)
     {
         Error_Handler(); // 传感器初始化失败，进入错误循环
     }
+    light_sensor = Sensor_FindByCap(SENSOR_CAP_LUX);
+    Sensor_Register(&Sensor_ADC); // ADC 后台扫描，监视供电电压
+    Sensor_Register(&Sensor_DHT11); // 没接 DHT11 时注册失败，不影响其他通道
+
+    /* 3. 采集时钟：TIM2 按固定周期触发各传感器，采样时刻不受主循环快慢影响 */
+    Acq_Init();
+    light_ch = Acq_AddChannel(light_sensor, LIGHT_PERIOD_MS, LIGHT_PHASE_MS);
+    adc_ch = Acq_AddChannel(Sensor_Find("ADC"), ADC_PERIOD_MS, ADC_PHASE_MS);
+    dht_ch = Acq_AddChannel(Sensor_Find("DHT11"), DHT_PERIOD_MS, DHT_PHASE_MS);
+
+    /* 4. 订阅传感器事件：显示逻辑只通过事件总线拿数据 */
+    EventBus_Init();
+    EventBus_Subscribe(EVT_SENSOR_READY, Display_OnSensorReady);
+    OLEDPower_Init();     // 订阅按键事件，按键唤醒屏幕
+#ifdef RS485_NODE_ADDR
+    LED_Init();
+    EventBus_Subscribe(EVT_UART_RX, Bus_OnUartRx);
+    RS485_Init(RS485_NODE_ADDR);
+#if RS485_NODE_ADDR != 0
+    EventBus_Subscribe(EVT_SENSOR_READY, Node_OnSensorReady);
+#endif
+#endif
+    Acq_Start();
 
-    /* 3. 主循环：持续读取光照度并显示 */
+    /* 5. 主循环：推进各通道采样，分发事件；不再用延时控制节拍 */
     while (1)
     {
-        // 读取 BH1750 光照度数据
-        if (BH1750_ReadLux(BH1750_I2C_PERIPH, &lux_value) == BH1750_OK)
+        if (Acq_Millis() != last_tick) // 1ms 节拍：按键计数消抖、RS-485 主机推进时隙，都不阻塞主循环
         {
-            // 格式化光照度字符串（如 "Lux: 123 lx" ）
-            sprintf(lux_str, "Lux: %d lx", lux_value);
+            uint8_t key = Key_GetNum();
+            last_tick = Acq_Millis();
+            if (key) EventBus_Publish(EVT_KEY, key, 0, 0);
 
-            OLED_Clear();                   // 清屏
-            OLED_ShowString(1, 1, "Light Sensor"); // 第 1 行显示标题 
-            OLED_ShowString(3, 1, "By: LiLu 15"); 
-            OLED_ShowString(2, 1, lux_str);       // 第 3 行显示光照度值
-        }
-        else
-        {
-            OLED_Clear();
-            OLED_ShowString(1, 1, "Sensor Error!"); // 读取失败提示
-            OLED_ShowString(3, 1, "By: LiLu 15");  // 错误信息时也显示名字
+#if defined(RS485_NODE_ADDR) && RS485_NODE_ADDR == 0
+            if (RS485_MasterTick(&node_online)) // 一个周期结束，所有从机数据已更新
+            {
+                sprintf(node_str, "Node: %d/%d", node_online, RS485_NODE_COUNT);
+                if (OLEDPower_IsOn()) OLED_UpdateLine(4, node_str); // 第 4 行显示在线从机数
+            }
+            if (last_tick - last_poll >= RS485_POLL_MS &&
+                RS485_MasterStart(node_table, RS485_NODE_COUNT) == RS485_OK)
+            {
+                last_poll = last_tick;
+            }
+#endif
         }
 
-        delay_ms(500); // 每隔 500ms 读取一次
+        Acq_Process();       // 已触发的通道依次 Start/Poll/Read，完成后发布 EVT_SENSOR_READY
+
+        EventBus_Dispatch(); // 调用所有订阅者
+        OLEDPower_Tick();    // 无操作超时熄屏
     }
 }
@@ -1,5 +1,14 @@
 #include "oled.h"
+#include "dwt.h"
+#include "ramfunc.h"
+#ifndef OLED_FONT_FULL
+#include "OLED_Font_Subset.h" // 裁剪后的字库，由 tools/oled_font_subset.py 生成
+#else
 #include "OLED_Font.h"
+#endif
+
+uint32_t OLED_HoldCycles = OLED_I2C_HOLD_CYCLES; // I2C 保持周期数，见 oled.h
+static char OLED_LineText[4][16];                  // OLED_UpdateLine 记录的各行内容，清屏后为空格
 
 /* OLED I2C 引脚初始化 */
 void OLED_I2C_Init(void)
@@ -11,13 +20,16 @@ void OLED_I2C_Init(void)
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;     // 输出速率50MHz
     GPIO_InitStructure.GPIO_Pin = OLED_SCL | OLED_SDA;    // 配置SCL和SDA引脚
     GPIO_Init(OLED_PROT, &GPIO_InitStructure);            // 初始化GPIO
+    DWT_Init();                                           // OLED_I2C_HOLD 依赖周期计数器
 
     OLED_W_SCL(1); // 设置SCL高电平
     OLED_W_SDA(1); // 设置SDA高电平
 }
 
+/* 以下 I2C 收发函数可放到 SRAM 执行（见 ramfunc.h） */
+
 /* I2C起始信号 */
-void OLED_I2C_Start(void)
+RAMFUNC void OLED_I2C_Start(void)
 {
     OLED_W_SDA(1);
     OLED_W_SCL(1);
@@ -26,7 +38,7 @@ void OLED_I2C_Start(void)
 }
 
 /* I2C停止信号 */
-void OLED_I2C_Stop(void)
+RAMFUNC void OLED_I2C_Stop(void)
 {
     OLED_W_SDA(0);
     OLED_W_SCL(1);
@@ -34,7 +46,7 @@ void OLED_I2C_Stop(void)
 }
 
 /* 通过I2C发送一个字节 */
-void OLED_I2C_SendByte(uint8_t Byte)
+RAMFUNC void OLED_I2C_SendByte(uint8_t Byte)
 {
     uint8_t i;
     for (i = 0; i < 8; i++) // 循环8次 逐位取出 Byte 的数据
@@ -48,7 +60,7 @@ void OLED_I2C_SendByte(uint8_t Byte)
 }
 
 /* 向OLED写入命令 */
-void OLED_WriteCommand(uint8_t Command)
+RAMFUNC void OLED_WriteCommand(uint8_t Command)
 {
     OLED_I2C_Start(); // 启动I2C通信
     OLED_I2C_SendByte(0x78); // OLED地址，写模式
@@ -58,7 +70,7 @@ void OLED_WriteCommand(uint8_t Command)
 }
 
 /* 向OLED写入数据 */
-void OLED_WriteData(uint8_t Data)
+RAMFUNC void OLED_WriteData(uint8_t Data)
 {
     OLED_I2C_Start();
     OLED_I2C_SendByte(0x78); // OLED地址，写模式
@@ -75,6 +87,36 @@ void OLED_SetCursor(uint8_t Y, uint8_t X) //Y（通常代表OLED的行）和 X
     OLED_WriteCommand(0x00 | (X & 0x0F));           // 设置列地址低4位
 }
 
+/* 设置对比度（0x00~0xFF，越大越亮、电流越大） */
+void OLED_SetContrast(uint8_t Contrast)
+{
+    OLED_WriteCommand(0x81);
+    OLED_WriteCommand(Contrast);
+}
+
+/* 设置预充电周期（低4位为阶段1，高4位为阶段2，单位 DCLK） */
+void OLED_SetPrecharge(uint8_t Precharge)
+{
+    OLED_WriteCommand(0xD9);
+    OLED_WriteCommand(Precharge);
+}
+
+/* 打开显示：先开充电泵再点亮 */
+void OLED_DisplayOn(void)
+{
+    OLED_WriteCommand(0x8D);
+    OLED_WriteCommand(0x14);
+    OLED_WriteCommand(0xAF);
+}
+
+/* 关闭显示进入睡眠，显存内容保留 */
+void OLED_DisplayOff(void)
+{
+    OLED_WriteCommand(0xAE);
+    OLED_WriteCommand(0x8D);         // 关闭充电泵
+    OLED_WriteCommand(0x10);
+}
+
 /* 清屏 */
 void OLED_Clear(void)
 {
@@ -87,24 +129,107 @@ void OLED_Clear(void)
             OLED_WriteData(0x00); // 写0清除像素
         }
     }
+    for (j = 0; j < 4; j++)
+    {
+        for (i = 0; i < 16; i++)
+        {
+            OLED_LineText[j][i] = ' ';
+        }
+    }
+}
+
+#ifndef OLED_FONT_FULL
+/* 在升序表中二分查找，返回下标，找不到返回 -1 */
+static int16_t OLED_SubsetFind(const uint8_t *Table, uint8_t Num, uint8_t Key)
+{
+    int16_t Low = 0, High = (int16_t)Num - 1, Mid;
+    while (Low <= High)
+    {
+        Mid = (Low + High) / 2;
+        if (Table[Mid] == Key) return Mid;
+        if (Table[Mid] < Key) Low = Mid + 1;
+        else High = Mid - 1;
+    }
+    return -1;
+}
+
+#if OLED_SUBSET_PACKED
+/* 解压一个列压缩字模：Src 开头是 Size/8 字节掩码（小端），后跟非零字节 */
+static void OLED_UnpackGlyph(const uint8_t *Src, uint8_t *Dst, uint8_t Size)
+{
+    uint32_t Mask = 0;
+    uint8_t i;
+    for (i = 0; i < Size / 8; i++)
+    {
+        Mask |= (uint32_t)Src[i] << (8 * i);
+    }
+    Src += Size / 8;
+    for (i = 0; i < Size; i++) // 固定循环次数，解码时间与字形无关
+    {
+        Dst[i] = (Mask & 1) ? *Src++ : 0x00;
+        Mask >>= 1;
+    }
+}
+#endif
+#endif
+
+/* 取出单个ASCII字符的 8x16 字模，字库中没有的字符显示为空格 */
+static const uint8_t *OLED_GetF8x16(char Char, uint8_t *Buf)
+{
+#ifndef OLED_FONT_FULL
+    int16_t Index = OLED_SubsetFind(OLED_SubsetChar, OLED_SUBSET_CHAR_NUM, (uint8_t)Char);
+    if (Index < 0)
+    {
+        Index = OLED_SubsetFind(OLED_SubsetChar, OLED_SUBSET_CHAR_NUM, ' '); // 生成工具保证空格一定存在
+    }
+#if OLED_SUBSET_PACKED
+    OLED_UnpackGlyph(&OLED_SubsetF8x16[OLED_SubsetF8x16Offset[Index]], Buf, 16);
+    return Buf;
+#else
+    (void)Buf;
+    return OLED_SubsetF8x16[Index];
+#endif
+#else
+    (void)Buf;
+    if (Char < ' ' || Char > '~') Char = ' ';
+    return OLED_F8x16[Char - ' '];
+#endif
 }
 
 /* 显示单个ASCII字符 */
 void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char)
 {
     uint8_t i; // 循环计数器
+    uint8_t Buf[16];
+    const uint8_t *Glyph = OLED_GetF8x16(Char, Buf);
     OLED_SetCursor((Line - 1) * 2, (Column - 1) * 8); // 上半部分行和列
     for (i = 0; i < 8; i++)
     {
-        OLED_WriteData(OLED_F8x16[Char - ' '][i]); // 显示上半部分
+        OLED_WriteData(Glyph[i]); // 显示上半部分
     }
     OLED_SetCursor((Line - 1) * 2 + 1, (Column - 1) * 8); // 下半部分
     for (i = 0; i < 8; i++)
     {
-        OLED_WriteData(OLED_F8x16[Char - ' '][i + 8]); // 显示下半部分
+        OLED_WriteData(Glyph[i + 8]); // 显示下半部分
     }
 }
 
+/* 测量单个字符的绘制开销（DWT周期数），返回总周期数，DecodeCycles 返回取字模/解压部分 */
+uint32_t OLED_MeasureGlyphCycles(uint8_t Line, uint8_t Column, char Char, uint32_t *DecodeCycles)
+{
+    uint8_t Buf[16];
+    uint32_t Start;
+
+    DWT_Init();
+    Start = DWT_GetCycles();
+    OLED_GetF8x16(Char, Buf);
+    if (DecodeCycles) *DecodeCycles = DWT_GetCycles() - Start;
+
+    Start = DWT_GetCycles();
+    OLED_ShowChar(Line, Column, Char);
+    return DWT_GetCycles() - Start;
+}
+
 /* 显示字符串 */
 void OLED_ShowString(uint8_t Line, uint8_t Column, char *String)
 {
@@ -115,19 +240,56 @@ void OLED_ShowString(uint8_t Line, uint8_t Column, char *String)
     }
 }
 
+/* 更新一整行：只重画与上次不同的字符，新字符串较短时用空格盖掉多出的部分
+   每个字符要写 16 字节加 6 条定位命令，每次都是一次完整的 I2C 传输，约 1.7ms；
+   同一行不要再混用 OLED_ShowString，否则记录的内容与屏幕不符 */
+void OLED_UpdateLine(uint8_t Line, char *String)
+{
+    char *Text = OLED_LineText[Line - 1];
+    uint8_t i;
+    char Char;
+
+    for (i = 0; i < 16; i++)
+    {
+        Char = *String ? *String++ : ' ';
+        if (Text[i] == Char) continue;
+        OLED_ShowChar(Line, i + 1, Char);
+        Text[i] = Char;
+    }
+}
+
 /* 显示汉字（16x16点阵） */
 void OLED_ShowChinese(uint8_t Line, uint8_t Column, uint8_t num)
 {
     uint8_t i;
+#ifndef OLED_FONT_FULL
+    static const uint8_t Blank[32] = {0};
+    const uint8_t *Glyph = Blank; // 字库中没有的汉字显示为空白
+#if OLED_SUBSET_PACKED
+    uint8_t Buf[32];
+#endif
+    int16_t Index = OLED_SubsetFind(OLED_SubsetHzIndex, OLED_SUBSET_HZ_NUM, num);
+    if (Index >= 0)
+    {
+#if OLED_SUBSET_PACKED
+        OLED_UnpackGlyph(&OLED_SubsetHzk1[OLED_SubsetHzk1Offset[Index]], Buf, 32);
+        Glyph = Buf;
+#else
+        Glyph = OLED_SubsetHzk1[Index];
+#endif
+    }
+#else
+    const unsigned char *Glyph = Hzk1[num];
+#endif
     OLED_SetCursor((Line - 1) * 2, (Column - 1) * 16); // 上半部分位置
     for (i = 0; i < 16; i++)
     {
-        OLED_WriteData(Hzk1[num][i]); // 显示上半部分
+        OLED_WriteData(Glyph[i]); // 显示上半部分
     }
     OLED_SetCursor((Line - 1) * 2 + 1, (Column - 1) * 16); // 下半部分
     for (i = 0; i < 16; i++)
     {
-        OLED_WriteData(Hzk1[num][i + 16]); // 显示下半部分
+        OLED_WriteData(Glyph[i + 16]); // 显示下半部分
     }
 }
 
@@ -0,0 +1,49 @@
+#ifndef __OLED_H
+#define __OLED_H
+
+#include "stm32f10x.h"
+#include "dwt.h"
+/*引脚配置*/
+
+#define OLED_SCL			GPIO_Pin_14
+#define OLED_SDA			GPIO_Pin_15
+#define OLED_PROT  			GPIOB
+
+/*每次翻转 SCL/SDA 后保持的 CPU 周期数：62 周期约 0.86us@72MHz，
+  低电平两段约 1.7us、高电平约 0.86us，满足 SSD1306 的 400kHz 时序。
+  每位约 3 次保持共 186 周期以上，一字节加应答约 1700 周期；OLED_WriteData 每字节都是一次
+  完整传输（起始+地址+控制字+数据+停止），约 5400 周期即 75us，整屏 1024 字节约 75ms。
+  运行时使用 OLED_HoldCycles，初值为本宏，可在编译选项中覆盖；设为 0 则不等待（只用于测量代码本身）*/
+#ifndef OLED_I2C_HOLD_CYCLES
+#define OLED_I2C_HOLD_CYCLES	62
+#endif
+extern uint32_t OLED_HoldCycles;
+#define OLED_I2C_HOLD()		do { uint32_t t_ = DWT_CYCCNT_REG; while (DWT_CYCCNT_REG - t_ < OLED_HoldCycles); } while (0)
+
+/*直接写 BSRR/BRR，不调用 Flash 中的库函数，放到 SRAM 执行时时序才确定*/
+#define OLED_W_SCL(x)		do { if (x) OLED_PROT->BSRR = OLED_SCL; else OLED_PROT->BRR = OLED_SCL; OLED_I2C_HOLD(); } while (0)
+#define OLED_W_SDA(x)		do { if (x) OLED_PROT->BSRR = OLED_SDA; else OLED_PROT->BRR = OLED_SDA; OLED_I2C_HOLD(); } while (0)
+
+/*字库配置：默认使用 tools/oled_font_subset.py 生成的 OLED_Font_Subset.h（只含用到的字模，
+  按生成时选定的格式列压缩或原样存放）；在工程中定义 OLED_FONT_FULL 则改用完整的 OLED_Font.h。
+  改了显示的字符串后要重新生成，否则缺的字符显示为空格，可用该工具的 --check 检查*/
+
+
+void OLED_Init(void);
+void OLED_WriteCommand(uint8_t Command);
+void OLED_WriteData(uint8_t Data);
+void OLED_Clear(void);
+void OLED_SetContrast(uint8_t Contrast);
+void OLED_SetPrecharge(uint8_t Precharge);
+void OLED_DisplayOn(void);
+void OLED_DisplayOff(void);
+void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char);
+void OLED_ShowString(uint8_t Line, uint8_t Column, char *String);
+void OLED_UpdateLine(uint8_t Line, char *String);   // 只重画变化的字符，刷新读数时代替清屏重画
+void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
+void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Length);
+void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
+void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
+void OLED_ShowChinese(uint8_t Line, uint8_t Column, uint8_t num);
+uint32_t OLED_MeasureGlyphCycles(uint8_t Line, uint8_t Column, char Char, uint32_t *DecodeCycles);
+#endif
@@ -0,0 +1,119 @@
+#include "oled_power.h"
+#include "oled.h"
+#include "dwt.h"
+#include "event_bus.h"
+
+// 档位表，按 MaxLux 升序。预充电周期长一些能提高亮度均匀性，但暗处用不着
+static const OLED_PowerLevel PowerLevel[] =
+{
+    {5,          0x08, 0x22},  // 夜间
+    {50,         0x30, 0x22},  // 昏暗室内
+    {300,        0x7F, 0xF1},  // 普通室内
+    {1000,       0xCF, 0xF1},  // 明亮室内（原 OLED_Init 的固定设置）
+    {0xFFFFFFFF, 0xFF, 0xF1},  // 日光
+};
+#define OLED_POWER_LEVEL_NUM  (sizeof(PowerLevel) / sizeof(PowerLevel[0]))
+
+static uint8_t  Level = 3;          // 与 OLED_Init 的设置一致
+static uint8_t  ForcedLevel = 0xFF;
+static uint8_t  DisplayOn = 1;
+static uint32_t IdleMs = 0;
+static uint32_t LastCycles;
+
+static void OLEDPower_Apply(uint8_t level)
+{
+    Level = level;
+    OLED_SetContrast(PowerLevel[level].Contrast);
+    OLED_SetPrecharge(PowerLevel[level].Precharge);
+}
+
+/* 按键事件：点亮屏幕 */
+static void OLEDPower_OnKey(const Event *evt)
+{
+    (void)evt;
+    OLEDPower_Wake();
+}
+
+void OLEDPower_Init(void)
+{
+    DWT_Init();
+    LastCycles = DWT_GetCycles();
+    IdleMs = 0;
+    DisplayOn = 1;
+    OLEDPower_Apply(Level);
+    EventBus_Subscribe(EVT_KEY, OLEDPower_OnKey);
+}
+
+/* 熄屏计时放在主循环里推进：只在采样成功时推进的话，传感器一直出错屏幕就永远不熄 */
+void OLEDPower_Tick(void)
+{
+    uint32_t now = DWT_GetCycles();
+    uint32_t cycles_per_ms = SystemCoreClock / 1000;
+    uint32_t ms = (now - LastCycles) / cycles_per_ms;
+
+    // 只累加整毫秒，余数留到下次，两次调用间隔需小于 59s（DWT 回绕周期）
+    LastCycles += ms * cycles_per_ms;
+    if (!DisplayOn) return; // 熄屏后不再计时，Wake 时清零
+
+    IdleMs += ms;
+    if (ForcedLevel != 0xFF) return; // 台架测量时不熄屏
+
+#if OLED_POWER_IDLE_TIMEOUT_MS > 0
+    if (IdleMs >= OLED_POWER_IDLE_TIMEOUT_MS)
+    {
+        OLED_DisplayOff();
+        DisplayOn = 0;
+    }
+#endif
+}
+
+void OLEDPower_Update(uint32_t lux)
+{
+    uint8_t target = Level;
+
+    if (ForcedLevel != 0xFF || !DisplayOn) return; // 台架测量时不换档，熄屏时不用换
+
+    // 升档：超过当前档上限；降档：低于下一档上限的 (100-回差)%
+    while (target < OLED_POWER_LEVEL_NUM - 1 && lux > PowerLevel[target].MaxLux)
+    {
+        target++;
+    }
+    while (target > 0 &&
+           lux < PowerLevel[target - 1].MaxLux * (100 - OLED_POWER_HYSTERESIS) / 100)
+    {
+        target--;
+    }
+    if (target != Level) OLEDPower_Apply(target);
+}
+
+void OLEDPower_Wake(void)
+{
+    IdleMs = 0;
+    if (!DisplayOn)
+    {
+        OLED_DisplayOn();
+        DisplayOn = 1;
+    }
+}
+
+void OLEDPower_ForceLevel(uint8_t level)
+{
+    if (level == 0xFF || level >= OLED_POWER_LEVEL_NUM)
+    {
+        ForcedLevel = 0xFF;
+        return;
+    }
+    ForcedLevel = level;
+    OLEDPower_Wake();
+    OLEDPower_Apply(level);
+}
+
+uint8_t OLEDPower_GetLevel(void)
+{
+    return Level;
+}
+
+uint8_t OLEDPower_IsOn(void)
+{
+    return DisplayOn;
+}
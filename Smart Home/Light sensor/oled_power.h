@@ -0,0 +1,31 @@
+#ifndef __OLED_POWER_H
+#define __OLED_POWER_H
+
+#include "stm32f10x.h"
+
+// OLED 显示功耗管理
+// 1. 按环境光照度选择对比度(0x81)和预充电周期(0xD9)，暗处降低驱动电流
+// 2. 无操作超时后关闭显示(0xAE)，按键或报警时重新点亮(0xAF)
+
+/***************根据自己需求更改****************/
+#define OLED_POWER_IDLE_TIMEOUT_MS  60000   // 无操作多久后熄屏，0 表示不熄屏
+#define OLED_POWER_HYSTERESIS       20      // 降档回差，百分比，防止光照在档位边界时来回切换
+/*********************END**********************/
+
+// 一个亮度档位：光照度不超过 MaxLux 时使用
+typedef struct
+{
+    uint32_t MaxLux;
+    uint8_t  Contrast;
+    uint8_t  Precharge;
+} OLED_PowerLevel;
+
+void OLEDPower_Init(void);              // 在 OLED_Init 和 EventBus_Init 之后调用
+void OLEDPower_Tick(void);              // 主循环每次调用，推进熄屏计时（与传感器是否读取成功无关）
+void OLEDPower_Update(uint32_t lux);    // 每次得到新的光照度时调用，按光照度换档
+void OLEDPower_Wake(void);              // 有用户操作或报警时调用
+void OLEDPower_ForceLevel(uint8_t level); // 台架测电流用：固定在某一档且不熄屏，0xFF 恢复自动
+uint8_t OLEDPower_GetLevel(void);
+uint8_t OLEDPower_IsOn(void);
+
+#endif
@@ -0,0 +1,50 @@
+#include "ramfunc.h"
+#include "dwt.h"
+#include "oled.h"
+
+#define RAMFUNC_MEASURE_NUM  64
+
+#if defined(RAMFUNC_ENABLE) && defined(__CC_ARM)
+extern unsigned int Image$$RAM_CODE$$Length; // 链接器生成，RAM_CODE 执行区长度
+#endif
+
+/* SRAM 中代码的大小，即启用 RAMFUNC 的 RAM 开销（RW_IRAM1 紧接其后，不预留空间） */
+uint32_t RamFunc_CodeSize(void)
+{
+#if defined(RAMFUNC_ENABLE) && defined(__CC_ARM)
+    return (uint32_t)&Image$$RAM_CODE$$Length;
+#else
+    return 0;
+#endif
+}
+
+static void RamFunc_Record(RamFunc_Timing *timing, uint32_t *sum, uint32_t cycles)
+{
+    if (cycles < timing->Min) timing->Min = cycles;
+    if (cycles > timing->Max) timing->Max = cycles;
+    *sum += cycles;
+}
+
+/* 测量 OLED_WriteCommand 的执行时间，发送 SSD1306 的空操作命令 0xE3，不影响显示
+   HoldCycles 为 0 时时钟远超 400kHz，屏幕可能收到错误命令，测完应重新 OLED_Init */
+void RamFunc_MeasureOLED(RamFunc_Timing *timing, uint32_t HoldCycles)
+{
+    uint32_t start, sum = 0, hold;
+    uint8_t i;
+
+    DWT_Init();
+    hold = OLED_HoldCycles;
+    OLED_HoldCycles = HoldCycles;
+    timing->Min = 0xFFFFFFFF;
+    timing->Max = 0;
+    for (i = 0; i < RAMFUNC_MEASURE_NUM; i++)
+    {
+        __disable_irq();                // 排除中断干扰，只看代码本身的抖动
+        start = DWT_GetCycles();
+        OLED_WriteCommand(0xE3);
+        RamFunc_Record(timing, &sum, DWT_GetCycles() - start);
+        __enable_irq();
+    }
+    OLED_HoldCycles = hold;
+    timing->Avg = sum / RAMFUNC_MEASURE_NUM;
+}
@@ -0,0 +1,33 @@
+#ifndef __RAMFUNC_H
+#define __RAMFUNC_H
+
+#include "stm32f10x.h"
+
+// 把时序敏感的函数放到 SRAM 执行：SRAM 无等待周期，执行时间不受 Flash 预取和代码对齐影响
+// 需要配合 STM32F103C8_ramfunc.sct 使用，并在工程中定义 RAMFUNC_ENABLE；
+// 未定义时 RAMFUNC 为空，函数照常放在 Flash，便于对比测量。
+// 标记为 RAMFUNC 的函数只能调用同样在 SRAM 中的函数或内联的寄存器操作，
+// 否则一调用 Flash 中的库函数就又回到了 Flash 的时序。
+// DHT11_Read_Bit/Read_Byte 也放在 SRAM，但它们用 DWT 测脉宽，结果本来就与取指速度无关，
+// 放到 SRAM 只让轮询间隔（边沿检测的分辨率）固定；没有传感器时只会走到 100us 超时，
+// 测不出有意义的差别，所以这里不提供 DHT11 的测量。
+#if defined(RAMFUNC_ENABLE) && defined(__CC_ARM)
+#define RAMFUNC  __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+// 单个函数的执行时间统计，单位为 CPU 周期
+typedef struct
+{
+    uint32_t Min;
+    uint32_t Max;
+    uint32_t Avg;
+} RamFunc_Timing;
+
+uint32_t RamFunc_CodeSize(void);                    // RAM_CODE 占用的 SRAM 字节数，未启用时为 0
+// 测量 OLED_WriteCommand 一次完整 I2C 传输，HoldCycles 为测量期间的 I2C 保持周期数：
+// 取 OLED_I2C_HOLD_CYCLES 得到实际耗时（主要是保持等待），取 0 只剩代码本身，才能看出取指的差别
+void RamFunc_MeasureOLED(RamFunc_Timing *timing, uint32_t HoldCycles);
+
+#endif
@@ -0,0 +1,337 @@
+#include "rs485.h"
+#include "dwt.h"
+#include "event_bus.h"
+#include <string.h>
+
+#define RS485_FRAME_MAX   (3 + RS485_MAX_DATA + 2)
+#define RS485_DE_TX()     GPIO_SetBits(RS485_DE_GPIO_PORT, RS485_DE_GPIO_PIN)
+#define RS485_DE_RX()     GPIO_ResetBits(RS485_DE_GPIO_PORT, RS485_DE_GPIO_PIN)
+
+static uint8_t MyAddr = 0;            // 0: 主机
+
+// 发送（中断驱动，TXE 逐字节发送，TC 后释放总线）
+static uint8_t TxBuf[RS485_FRAME_MAX];
+static uint8_t TxLen, TxPos;
+static volatile uint8_t TxBusy = 0;
+
+// 接收状态机，在中断中运行；总线空闲(IDLE)时复位，用于帧同步
+static uint8_t RxBuf[RS485_FRAME_MAX];
+static uint8_t RxPos = 0;
+
+// 从机：双缓冲的待应答数据，主循环写非活动缓冲后切换索引，中断只读活动缓冲
+static uint8_t SlaveSample[2][RS485_SAMPLE_LEN];
+static volatile uint8_t SlaveActive = 0;
+static uint8_t ReplyPending = 0;      // 收到发给本机的请求，等总线空闲后应答
+
+// 主机：当前等待应答的地址和收到的数据，应答在中断中收下并记录延迟
+static volatile uint8_t PendingAddr = 0;
+static volatile uint8_t RespReady = 0;
+static volatile uint16_t RespUs;
+static uint8_t RespData[RS485_SAMPLE_LEN];
+
+// 主机轮询周期状态，由 RS485_MasterTick 每 1ms 推进
+static Sensor_Data *MasterTable = 0;  // 非 0 表示周期进行中
+static uint8_t MasterCount, MasterSlot, MasterTicks, MasterOnline;
+static uint32_t SlotStart, CycleStart;
+
+static RS485_NodeStats NodeStats[RS485_MAX_NODES];
+static RS485_BusStats BusStats;
+static uint32_t LastCycleStart;       // 上一次轮询周期开始的时刻
+
+/* Modbus CRC16，初值 0xFFFF，多项式 0xA001 */
+static uint16_t RS485_CRC16(const uint8_t *buf, uint8_t len)
+{
+    uint16_t crc = 0xFFFF;
+    uint8_t i;
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (i = 0; i < 8; i++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+/* 填好帧头和 CRC 后启动中断发送 */
+static void RS485_Send(uint8_t addr, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    uint16_t crc;
+
+    TxBuf[0] = addr;
+    TxBuf[1] = cmd;
+    TxBuf[2] = len;
+    if (len) memcpy(&TxBuf[3], data, len);
+    crc = RS485_CRC16(TxBuf, 3 + len);
+    TxBuf[3 + len] = crc & 0xFF;
+    TxBuf[4 + len] = crc >> 8;
+
+    TxLen = 5 + len;
+    TxPos = 0;
+    TxBusy = 1;
+    RS485_DE_TX();                              // 切换到发送
+    USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+}
+
+/* 收到完整帧，在中断中调用 */
+static void RS485_OnFrame(uint8_t len)
+{
+    uint16_t crc = RxBuf[3 + len] | (RxBuf[4 + len] << 8);
+
+    if (RS485_CRC16(RxBuf, 3 + len) != crc)
+    {
+        BusStats.CrcErrors++;
+        return;
+    }
+    EventBus_Publish(EVT_UART_RX, RxBuf[0], RxBuf[1], len); // 通知主循环，应答本身不依赖主循环
+
+    if (MyAddr != 0)
+    {
+        // 从机：不在收到最后一个字节时立即应答，此时主机可能还没在 TC 中断里释放 DE，
+        // 两边驱动器会短暂冲突；等 IDLE 中断（至少空闲一个字符时间）再应答，仍不依赖主循环
+        if (RxBuf[0] == MyAddr && RxBuf[1] == RS485_CMD_READ && !TxBusy)
+        {
+            ReplyPending = 1;
+        }
+    }
+    else if (RxBuf[0] == PendingAddr && RxBuf[1] == (RS485_CMD_READ | 0x80) && len == RS485_SAMPLE_LEN)
+    {
+        // 在中断里计时，主循环晚几百微秒才看到也不影响延迟和超时判定；超时后到的应答丢弃
+        uint32_t us = DWT_CyclesToUs(DWT_GetCycles() - SlotStart);
+        if (us < RS485_TIMEOUT_US)
+        {
+            memcpy(RespData, &RxBuf[3], RS485_SAMPLE_LEN);
+            RespUs = us;
+            RespReady = 1;
+        }
+    }
+}
+
+static void RS485_RxByte(uint8_t b)
+{
+    RxBuf[RxPos++] = b;
+    if (RxPos >= 3)
+    {
+        if (RxBuf[2] > RS485_MAX_DATA)          // 长度非法，等待下一次总线空闲重新同步
+        {
+            RxPos = 0;
+            return;
+        }
+        if (RxPos == 5 + RxBuf[2])
+        {
+            RS485_OnFrame(RxBuf[2]);
+            RxPos = 0;
+        }
+    }
+}
+
+void USART1_IRQHandler(void)
+{
+    if (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET)
+    {
+        RS485_RxByte(USART_ReceiveData(USART1)); // 读 DR 同时清除 RXNE
+    }
+    if (USART_GetFlagStatus(USART1, USART_FLAG_ORE) != RESET)
+    {
+        USART_ReceiveData(USART1);              // 读 SR 再读 DR 清除 ORE
+        BusStats.RxOverrun++;
+        RxPos = 0;
+    }
+    if (USART_GetITStatus(USART1, USART_IT_IDLE) != RESET)
+    {
+        USART_ReceiveData(USART1);              // 读 SR 再读 DR 清除 IDLE
+        RxPos = 0;                              // 帧间空闲，丢弃不完整的帧
+        if (ReplyPending)
+        {
+            ReplyPending = 0;
+            RS485_Send(MyAddr, RS485_CMD_READ | 0x80, SlaveSample[SlaveActive], RS485_SAMPLE_LEN);
+        }
+    }
+    if (USART_GetITStatus(USART1, USART_IT_TXE) != RESET)
+    {
+        USART_SendData(USART1, TxBuf[TxPos++]);
+        if (TxPos >= TxLen)
+        {
+            USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+            USART_ITConfig(USART1, USART_IT_TC, ENABLE); // 等最后一位移出再释放总线
+        }
+    }
+    if (USART_GetITStatus(USART1, USART_IT_TC) != RESET)
+    {
+        USART_ITConfig(USART1, USART_IT_TC, DISABLE);
+        USART_ClearITPendingBit(USART1, USART_IT_TC);
+        RS485_DE_RX();                          // 切回接收
+        TxBusy = 0;
+    }
+}
+
+/* 初始化 USART1 和 DE 引脚，address=0 为主机 */
+void RS485_Init(uint8_t address)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    USART_InitTypeDef USART_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    MyAddr = address;
+    ReplyPending = 0;
+    memset(NodeStats, 0, sizeof(NodeStats));
+    memset(&BusStats, 0, sizeof(BusStats));
+    memset(SlaveSample, 0, sizeof(SlaveSample));
+    DWT_Init();
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1 | RCC_APB2Periph_GPIOA | RS485_DE_GPIO_CLK, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;       // 复用推挽输出
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;         // 上拉输入：发送期间 /RE 为高，RO 高阻，上拉保持空闲电平
+    GPIO_Init(GPIOA, &GPIO_InitStructure);
+
+    GPIO_InitStructure.GPIO_Pin = RS485_DE_GPIO_PIN;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;      // DE 推挽输出，默认接收
+    GPIO_Init(RS485_DE_GPIO_PORT, &GPIO_InitStructure);
+    RS485_DE_RX();
+
+    USART_InitStructure.USART_BaudRate = RS485_BAUDRATE;
+    USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+    USART_InitStructure.USART_StopBits = USART_StopBits_1;
+    USART_InitStructure.USART_Parity = USART_Parity_No;
+    USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+    USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+    USART_Init(USART1, &USART_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+    USART_ITConfig(USART1, USART_IT_IDLE, ENABLE);
+    USART_Cmd(USART1, ENABLE);
+}
+
+/* 从机：更新应答数据，只在主循环中调用 */
+void RS485_SlaveSetSample(const Sensor_Data *data)
+{
+    uint8_t *p = SlaveSample[!SlaveActive];
+
+    p[0] = data->Temp & 0xFF;
+    p[1] = (uint16_t)data->Temp >> 8;
+    p[2] = data->Humi & 0xFF;
+    p[3] = data->Humi >> 8;
+    p[4] = data->Lux & 0xFF;
+    p[5] = (data->Lux >> 8) & 0xFF;
+    p[6] = (data->Lux >> 16) & 0xFF;
+    p[7] = data->Lux >> 24;
+    p[8] = data->Valid;
+    SlaveActive = !SlaveActive;                 // 写完再切换，中断不会读到一半的数据
+}
+
+/* 主机：向当前时隙的从机发出请求 */
+static void RS485_MasterSend(void)
+{
+    NodeStats[MasterSlot].Polls++;
+    MasterTicks = 0;
+    RespReady = 0;
+    SlotStart = DWT_GetCycles();                // 先记时刻再置地址，中断里用它计算延迟
+    PendingAddr = MasterSlot + 1;
+    RS485_Send(MasterSlot + 1, RS485_CMD_READ, 0, 0);
+}
+
+/* 主机：开始一个轮询周期，发出第一个请求后立即返回；上一周期未结束时返回 RS485_ERROR */
+RS485_STATUS RS485_MasterStart(Sensor_Data *table, uint8_t count)
+{
+    if (MyAddr != 0 || MasterTable != 0 || TxBusy || count == 0) return RS485_ERROR;
+    if (count > RS485_MAX_NODES) count = RS485_MAX_NODES;
+
+    CycleStart = DWT_GetCycles();
+    if (BusStats.Cycles) BusStats.LastIntervalUs = DWT_CyclesToUs(CycleStart - LastCycleStart);
+    LastCycleStart = CycleStart;
+
+    MasterTable = table;
+    MasterCount = count;
+    MasterSlot = 0;
+    MasterOnline = 0;
+    RS485_MasterSend();
+    return RS485_OK;
+}
+
+/* 主机：每 1ms 调用一次，每次最多推进一个时隙，不等待总线。
+   时隙为 RS485_SLOT_US 对应的节拍数，周期 = count * RS485_SLOT_US，与从机是否在线无关；
+   请求发出晚了导致超时窗口未满时，时隙顺延一个节拍，不会在迟到的应答上发下一个请求。
+   周期结束时返回 1，并通过 online 给出本周期在线数量 */
+uint8_t RS485_MasterTick(uint8_t *online)
+{
+    RS485_NodeStats *stats;
+    Sensor_Data *data;
+    uint32_t us;
+
+    if (MasterTable == 0) return 0;
+    MasterTicks++;
+
+    if (PendingAddr)
+    {
+        stats = &NodeStats[MasterSlot];
+        data = &MasterTable[MasterSlot];
+        if (RespReady)
+        {
+            PendingAddr = 0;
+            stats->LastLatencyUs = RespUs;
+            if (RespUs > stats->MaxLatencyUs) stats->MaxLatencyUs = RespUs;
+            stats->Ok++;
+            MasterOnline++;
+
+            data->Temp = (int16_t)(RespData[0] | (RespData[1] << 8));
+            data->Humi = RespData[2] | (RespData[3] << 8);
+            data->Lux = RespData[4] | (RespData[5] << 8) | ((uint32_t)RespData[6] << 16) | ((uint32_t)RespData[7] << 24);
+            data->Valid = RespData[8];
+        }
+        else if (DWT_CyclesToUs(DWT_GetCycles() - SlotStart) >= RS485_TIMEOUT_US)
+        {
+            PendingAddr = 0;                    // 此后中断计得的延迟也不小于超时，迟到的应答不会被收下
+            stats->Timeout++;
+            data->Valid = 0;
+        }
+    }
+    if (PendingAddr || MasterTicks < RS485_SLOT_US / 1000) return 0;
+
+    if (++MasterSlot < MasterCount)
+    {
+        RS485_MasterSend();                     // 下一个时隙
+        return 0;
+    }
+
+    us = DWT_CyclesToUs(DWT_GetCycles() - CycleStart);
+    BusStats.LastCycleUs = us;
+    if (BusStats.Cycles == 0 || us < BusStats.MinCycleUs) BusStats.MinCycleUs = us;
+    if (us > BusStats.MaxCycleUs) BusStats.MaxCycleUs = us;
+    BusStats.Cycles++;
+    MasterTable = 0;
+    if (online) *online = MasterOnline;
+    return 1;
+}
+
+const RS485_NodeStats *RS485_GetNodeStats(uint8_t address)
+{
+    if (address == 0 || address > RS485_MAX_NODES) return 0;
+    return &NodeStats[address - 1];
+}
+
+const RS485_BusStats *RS485_GetBusStats(void)
+{
+    return &BusStats;
+}
+
+/* 节点有效数据吞吐量：每个轮询间隔 RS485_SAMPLE_LEN 字节，按成功率折算；
+   应用每隔一段时间才轮询一次，所以按实际轮询间隔而不是周期本身的时长计算 */
+uint32_t RS485_NodeThroughput(uint8_t address)
+{
+    const RS485_NodeStats *stats = RS485_GetNodeStats(address);
+    if (stats == 0 || stats->Polls == 0 || BusStats.LastIntervalUs == 0) return 0;
+    return (uint32_t)((uint64_t)RS485_SAMPLE_LEN * 1000000 * stats->Ok / stats->Polls / BusStats.LastIntervalUs);
+}
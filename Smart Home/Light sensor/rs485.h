@@ -0,0 +1,72 @@
+#ifndef __RS485_H
+#define __RS485_H
+
+#include "stm32f10x.h"
+#include "sensor.h"
+
+// USART1 半双工 RS-485 多机通信（主机轮询，TDMA 固定时隙）
+// 硬件连接：PA9=TX -> DI，PA10=RX <- RO，PA8 -> DE 和 /RE（高电平发送）
+// 启用后 USART1 不再用于 printf。
+//
+// 帧格式（与 tools/rs485_sim.py 一致）：
+//   ADDR(1) CMD(1) LEN(1) DATA(LEN) CRC16(2, Modbus 多项式 0xA001，低字节在前)
+//   请求：CMD=RS485_CMD_READ，LEN=0
+//   应答：CMD=RS485_CMD_READ|0x80，DATA=Temp(int16) Humi(uint16) Lux(uint32) Valid(uint8)，均为小端
+
+/***************根据自己需求更改****************/
+#define RS485_BAUDRATE        115200
+#define RS485_DE_GPIO_PORT    GPIOA
+#define RS485_DE_GPIO_PIN     GPIO_Pin_8
+#define RS485_DE_GPIO_CLK     RCC_APB2Periph_GPIOA
+#define RS485_MAX_NODES       32      // 从机地址 1~32
+#define RS485_SLOT_US         3000    // 每个从机的时隙，包含请求、应答和总线翻转；按 1ms 节拍推进，取 1000 的整数倍
+#define RS485_TIMEOUT_US      2500    // 等待应答超时，必须小于时隙
+/*********************END**********************/
+
+#define RS485_CMD_READ        0x01
+#define RS485_MAX_DATA        16
+#define RS485_SAMPLE_LEN      9
+
+typedef enum
+{
+    RS485_OK = 0,
+    RS485_TIMEOUT,
+    RS485_ERROR      // 参数错误或总线忙
+} RS485_STATUS;
+
+// 每个从机的统计
+typedef struct
+{
+    uint32_t Polls;
+    uint32_t Ok;
+    uint32_t Timeout;
+    uint16_t LastLatencyUs;  // 发出请求到收到完整应答
+    uint16_t MaxLatencyUs;
+} RS485_NodeStats;
+
+// 总线统计
+typedef struct
+{
+    uint32_t Cycles;
+    uint32_t LastCycleUs;
+    uint32_t MinCycleUs;
+    uint32_t MaxCycleUs;
+    uint32_t LastIntervalUs; // 相邻两次轮询周期开始的间隔，即实际轮询间隔（不超过 59s）
+    uint32_t CrcErrors;      // 所有校验失败的帧
+    uint32_t RxOverrun;      // 接收溢出
+} RS485_BusStats;
+
+void RS485_Init(uint8_t address);                      // address=0 为主机，1~32 为从机
+
+// 从机
+void RS485_SlaveSetSample(const Sensor_Data *data);    // 更新待应答的数据，应答在中断中完成
+
+// 主机（非阻塞）：RS485_MasterStart 发出第一个请求后返回，之后每 1ms 调用一次 RS485_MasterTick，
+// 每次最多推进一个时隙，应答由 USART 中断接收；周期进行中 table 里的数据逐个更新
+RS485_STATUS RS485_MasterStart(Sensor_Data *table, uint8_t count); // 开始轮询地址 1~count，忙时返回 RS485_ERROR
+uint8_t RS485_MasterTick(uint8_t *online);             // 周期结束时返回 1，online 为本周期在线数量
+const RS485_NodeStats *RS485_GetNodeStats(uint8_t address);
+const RS485_BusStats *RS485_GetBusStats(void);
+uint32_t RS485_NodeThroughput(uint8_t address);        // 该节点有效数据吞吐量，字节/秒
+
+#endif
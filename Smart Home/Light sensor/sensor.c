@@ -0,0 +1,123 @@
+#include "sensor.h"
+#include "dwt.h"
+#include "delay.h"
+#include <string.h>
+
+static const Sensor_Driver *SensorTable[SENSOR_MAX_NUM];
+static uint8_t SensorNum = 0;
+static Sensor_ClockFunc Clock = 0;
+static uint32_t ClockMs = 0;       // 默认时钟：已累加的整毫秒
+static uint32_t ClockCycles = 0;   // 默认时钟：ClockMs 对应的 DWT 周期数
+
+/* 初始化传感器并加入注册表，初始化失败的传感器不会注册 */
+SENSOR_STATUS Sensor_Register(const Sensor_Driver *drv)
+{
+    if (SensorNum >= SENSOR_MAX_NUM) return SENSOR_ERROR;
+
+    DWT_Init(); // Poll 依赖周期计数器计时
+    if (drv->Init() != SENSOR_OK) return SENSOR_ERROR;
+
+    SensorTable[SensorNum++] = drv;
+    return SENSOR_OK;
+}
+
+uint8_t Sensor_Count(void)
+{
+    return SensorNum;
+}
+
+const Sensor_Driver *Sensor_Get(uint8_t index)
+{
+    return index < SensorNum ? SensorTable[index] : 0;
+}
+
+/* 按名字查找 */
+const Sensor_Driver *Sensor_Find(const char *name)
+{
+    uint8_t i;
+    for (i = 0; i < SensorNum; i++)
+    {
+        if (strcmp(SensorTable[i]->Name, name) == 0) return SensorTable[i];
+    }
+    return 0;
+}
+
+/* 按能力查找，先注册的优先，应用可先注册更快/更精确的传感器 */
+const Sensor_Driver *Sensor_FindByCap(uint8_t caps)
+{
+    uint8_t i;
+    for (i = 0; i < SensorNum; i++)
+    {
+        if ((SensorTable[i]->Caps & caps) == caps) return SensorTable[i];
+    }
+    return 0;
+}
+
+/* 完整读取一次：Start -> 等待 Poll 就绪 -> Read */
+SENSOR_STATUS Sensor_ReadBlocking(const Sensor_Driver *drv, Sensor_Data *data)
+{
+    SENSOR_STATUS status;
+    uint32_t start, stamp_ms;
+    uint16_t stamp_us;
+
+    // 距上次读取太近时 Start/Poll 会返回 BUSY，这里一并等待
+    start = Sensor_Now();
+    while ((status = drv->Start()) == SENSOR_BUSY)
+    {
+        if (Sensor_Elapsed(start, drv->MinPeriodMs + 10)) return SENSOR_ERROR;
+        delay_ms(1);
+    }
+    if (status != SENSOR_OK) return status;
+    Sensor_Timestamp(&stamp_ms, &stamp_us); // 转换从 Start 开始
+
+    start = Sensor_Now();
+    while ((status = drv->Poll()) == SENSOR_BUSY)
+    {
+        if (Sensor_Elapsed(start, drv->ConvTimeMs + 10)) return SENSOR_ERROR; // 超时
+        delay_ms(1);
+    }
+    if (status != SENSOR_OK) return status;
+
+    memset(data, 0, sizeof(Sensor_Data));
+    status = drv->Read(data);
+    data->Timestamp = stamp_ms;
+    data->TimestampUs = stamp_us;
+    return status;
+}
+
+/* 默认时钟：把 DWT 周期数累加成毫秒，余数留到下次，CYCCNT 回绕不影响单调性 */
+static void Sensor_DwtClock(uint32_t *ms, uint16_t *us)
+{
+    uint32_t cycles_per_ms = SystemCoreClock / 1000;
+    uint32_t cycles = DWT_GetCycles() - ClockCycles;
+    uint32_t n = cycles / cycles_per_ms;
+
+    ClockCycles += n * cycles_per_ms;
+    ClockMs += n;
+    *ms = ClockMs;
+    *us = (uint16_t)((cycles - n * cycles_per_ms) / DWT_CYCLES_PER_US);
+}
+
+void Sensor_SetClock(Sensor_ClockFunc clock)
+{
+    Clock = clock;
+}
+
+/* 取时间戳，只在主循环中调用 */
+void Sensor_Timestamp(uint32_t *ms, uint16_t *us)
+{
+    if (Clock) Clock(ms, us);
+    else Sensor_DwtClock(ms, us);
+}
+
+/* 当前时刻（DWT 周期数） */
+uint32_t Sensor_Now(void)
+{
+    return DWT_GetCycles();
+}
+
+/* 自 since 起是否已经过 ms 毫秒 */
+uint8_t Sensor_Elapsed(uint32_t since, uint16_t ms)
+{
+    return (DWT_GetCycles() - since) >= (uint32_t)ms * (SystemCoreClock / 1000);
+}
@@ -0,0 +1,83 @@
+#ifndef __SENSOR_H
+#define __SENSOR_H
+
+#include "stm32f10x.h"
+
+// 通用传感器驱动接口
+// 应用只通过 Start/Poll/Read 访问传感器，更换传感器（如 DHT11 -> SHT3x）
+// 只需注册不同的驱动，不用改应用代码。
+// 典型用法：Start() 触发一次转换 -> 轮询 Poll() 直到返回 SENSOR_OK -> Read() 取数据
+
+typedef enum
+{
+    SENSOR_OK = 0,
+    SENSOR_ERROR,
+    SENSOR_BUSY    // 转换未完成或距上次读取太近
+} SENSOR_STATUS;
+
+// 能力位
+#define SENSOR_CAP_TEMP   0x01  // 温度
+#define SENSOR_CAP_HUMI   0x02  // 湿度
+#define SENSOR_CAP_LUX    0x04  // 光照度
+#define SENSOR_CAP_VDD    0x08  // 供电电压
+#define SENSOR_CAP_CHIP   0x10  // 芯片内部温度
+#define SENSOR_CAP_ANALOG 0x20  // 外部模拟通道
+
+#define SENSOR_ANALOG_NUM 2     // Sensor_Data 中的模拟通道数
+
+// 统一的数据格式，Valid 标记哪些字段有效（SENSOR_CAP_xxx）
+typedef struct
+{
+    int16_t  Temp;   // 温度，单位 0.1°C
+    uint16_t Humi;   // 湿度，单位 0.1%RH
+    uint32_t Lux;    // 光照度，单位 lx
+    uint16_t Vdd;    // 供电电压，单位 0.1mV
+    int16_t  ChipTemp; // 芯片温度，单位 0.1°C
+    uint16_t Analog[SENSOR_ANALOG_NUM]; // 外部模拟输入，单位 0.1mV（12 位 1LSB 约 0.8mV，过采样后才有意义）
+    uint32_t Timestamp;   // 开始转换的时刻，毫秒，单调递增，约 49 天回绕；时钟来源见 Sensor_SetClock
+    uint16_t TimestampUs; // 同一时刻毫秒以下的部分，0~999us；两项由 Sensor_ReadBlocking/Acq_Process 填写
+    uint8_t  Valid;
+} Sensor_Data;
+
+typedef struct
+{
+    const char *Name;
+    uint8_t  Caps;          // SENSOR_CAP_xxx 组合
+    uint16_t ConvTimeMs;    // Start 到数据就绪的最长时间；单总线等在 Read 中阻塞的传感器填 Read 的阻塞时间
+    uint16_t MinPeriodMs;   // 两次读取的最小间隔，0 表示无限制
+    uint8_t  TempRes;       // 温度分辨率，单位 0.1°C（无温度能力时为 0）
+    SENSOR_STATUS (*Init)(void);                 // 初始化并检测传感器
+    SENSOR_STATUS (*Start)(void);                // 触发一次转换
+    SENSOR_STATUS (*Poll)(void);                 // SENSOR_OK 表示数据就绪
+    SENSOR_STATUS (*Read)(Sensor_Data *data);    // 读取转换结果
+} Sensor_Driver;
+
+/***************根据自己需求更改****************/
+#define SENSOR_MAX_NUM    4   // 注册表容量
+/*********************END**********************/
+
+// 现有的驱动
+extern const Sensor_Driver Sensor_BH1750;
+extern const Sensor_Driver Sensor_DHT11;
+extern const Sensor_Driver Sensor_DHT22;
+extern const Sensor_Driver Sensor_SHT3x;
+extern const Sensor_Driver Sensor_ADC;
+
+SENSOR_STATUS Sensor_Register(const Sensor_Driver *drv);  // 调用 Init，成功才加入注册表
+uint8_t Sensor_Count(void);
+const Sensor_Driver *Sensor_Get(uint8_t index);
+const Sensor_Driver *Sensor_Find(const char *name);
+const Sensor_Driver *Sensor_FindByCap(uint8_t caps);      // 按注册顺序返回第一个满足能力的驱动
+SENSOR_STATUS Sensor_ReadBlocking(const Sensor_Driver *drv, Sensor_Data *data);
+
+// 时间戳时钟：返回当前毫秒数和毫秒以下的微秒数。默认由 DWT 周期数累加而成，
+// 两次取时间戳的间隔需小于 59s；Acq_Start 后改用采集时钟（TIM2），与 Acq_Process 的时间戳一致
+typedef void (*Sensor_ClockFunc)(uint32_t *ms, uint16_t *us);
+void Sensor_SetClock(Sensor_ClockFunc clock);             // 0 恢复默认时钟
+void Sensor_Timestamp(uint32_t *ms, uint16_t *us);
+
+// 供驱动使用的计时工具（基于 DWT 周期计数器，单次计时不超过 59s）
+uint32_t Sensor_Now(void);
+uint8_t Sensor_Elapsed(uint32_t since, uint16_t ms);      // 返回1:已经过 ms 毫秒
+
+#endif
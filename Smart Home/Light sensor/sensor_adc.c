@@ -0,0 +1,144 @@
+#include "sensor.h"
+
+// ADC1 扫描 + DMA 循环传输：内部基准 Vrefint、内部温度传感器和若干外部模拟通道
+// ADC 连续转换，DMA 不断刷新 AdcBuf，转换过程不占 CPU；
+// Read 时把缓冲中 ADC_OVERSAMPLE 组数据求和，过采样 16 倍可多得 2 位有效分辨率。
+
+/***************根据自己需求更改****************/
+#define ADC_EXT_GPIO_PORT   GPIOA
+#define ADC_EXT_GPIO_PINS   (GPIO_Pin_0 | GPIO_Pin_1)
+#define ADC_EXT_GPIO_CLK    RCC_APB2Periph_GPIOA
+static const uint8_t AdcExtChannel[SENSOR_ANALOG_NUM] = {ADC_Channel_0, ADC_Channel_1}; // PA0, PA1
+/*********************END**********************/
+
+#define ADC_OVERSAMPLE      16                        // 每通道过采样次数
+#define ADC_CH_NUM          (2 + SENSOR_ANALOG_NUM)   // 扫描序列：Vrefint, 温度, 外部通道...
+#define ADC_VREFINT_MV      1200                      // 内部基准典型值 1.20V
+#define ADC_TEMP_V25_MV     1430                      // 温度传感器 25°C 时 1.43V
+#define ADC_TEMP_SLOPE_UV   4300                      // 4.3mV/°C
+// ADCCLK=12MHz，采样 239.5 周期（温度传感器要求 ≥17.1us），每通道 21us，
+// 一轮扫描 84us，整个缓冲约 1.35ms 刷新一遍
+#define ADC_CONV_MS         2
+
+static volatile uint16_t AdcBuf[ADC_OVERSAMPLE][ADC_CH_NUM];
+
+/* 通道 ch 的 ADC_OVERSAMPLE 次采样之和 */
+static uint32_t ADC_Sum(uint8_t ch)
+{
+    uint32_t sum = 0;
+    uint8_t i;
+    for (i = 0; i < ADC_OVERSAMPLE; i++)
+    {
+        sum += AdcBuf[i][ch];
+    }
+    return sum;
+}
+
+static SENSOR_STATUS ADC_SensorInit(void)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
+    ADC_InitTypeDef ADC_InitStructure;
+    uint8_t i;
+
+    RCC_ADCCLKConfig(RCC_PCLK2_Div6);                       // 72MHz / 6 = 12MHz（不能超过 14MHz）
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1 | ADC_EXT_GPIO_CLK, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin = ADC_EXT_GPIO_PINS;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;           // 模拟输入
+    GPIO_Init(ADC_EXT_GPIO_PORT, &GPIO_InitStructure);
+
+    // DMA1 通道1：ADC1->DR 循环搬运到 AdcBuf
+    DMA_DeInit(DMA1_Channel1);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ADC1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)AdcBuf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = ADC_OVERSAMPLE * ADC_CH_NUM;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+    DMA_Cmd(DMA1_Channel1, ENABLE);
+
+    // ADC1：独立模式，扫描 + 连续转换，软件启动一次后一直运行
+    ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;
+    ADC_InitStructure.ADC_ScanConvMode = ENABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = ENABLE;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfChannel = ADC_CH_NUM;
+    ADC_Init(ADC1, &ADC_InitStructure);
+
+    ADC_RegularChannelConfig(ADC1, ADC_Channel_Vrefint, 1, ADC_SampleTime_239Cycles5);
+    ADC_RegularChannelConfig(ADC1, ADC_Channel_TempSensor, 2, ADC_SampleTime_239Cycles5);
+    for (i = 0; i < SENSOR_ANALOG_NUM; i++)
+    {
+        ADC_RegularChannelConfig(ADC1, AdcExtChannel[i], 3 + i, ADC_SampleTime_239Cycles5);
+    }
+    ADC_TempSensorVrefintCmd(ENABLE);
+    ADC_DMACmd(ADC1, ENABLE);
+    ADC_Cmd(ADC1, ENABLE);
+
+    // 校准
+    ADC_ResetCalibration(ADC1);
+    while (ADC_GetResetCalibrationStatus(ADC1));
+    ADC_StartCalibration(ADC1);
+    while (ADC_GetCalibrationStatus(ADC1));
+
+    ADC_SoftwareStartConvCmd(ADC1, ENABLE);
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS ADC_SensorStart(void)
+{
+    return SENSOR_OK; // 一直在转换
+}
+
+static SENSOR_STATUS ADC_SensorPoll(void)
+{
+    // 缓冲第一次填满前数据不完整；TC 标志置位后不清除，之后一直就绪
+    return DMA_GetFlagStatus(DMA1_FLAG_TC1) != RESET ? SENSOR_OK : SENSOR_BUSY;
+}
+
+static SENSOR_STATUS ADC_SensorRead(Sensor_Data *data)
+{
+    uint32_t vref = ADC_Sum(0);
+    uint32_t mv10;  // 0.1mV，过采样和最大 65520，乘 12000 不会溢出
+    uint8_t i;
+
+    if (vref == 0) return SENSOR_ERROR;
+
+    // 过采样和的比值与单次采样相同：VDD = 1.2V * 4095 / Vrefint
+    // 所有电压都用 0.1mV 计算和输出，保留过采样得到的分辨率（按 mV 输出会把它舍掉）
+    data->Vdd = (uint16_t)((uint32_t)ADC_VREFINT_MV * 10 * 4095 * ADC_OVERSAMPLE / vref);
+
+    // 以 Vrefint 为参考换算，结果与 VDD 波动无关：V = 1.2V * raw / Vrefint
+    mv10 = ADC_Sum(1) * ADC_VREFINT_MV * 10 / vref;
+    data->ChipTemp = (int16_t)(((int32_t)ADC_TEMP_V25_MV * 10 - (int32_t)mv10) * 1000 / ADC_TEMP_SLOPE_UV + 250);
+
+    for (i = 0; i < SENSOR_ANALOG_NUM; i++)
+    {
+        data->Analog[i] = (uint16_t)(ADC_Sum(2 + i) * ADC_VREFINT_MV * 10 / vref);
+    }
+
+    data->Valid |= SENSOR_CAP_VDD | SENSOR_CAP_CHIP | SENSOR_CAP_ANALOG;
+    return SENSOR_OK;
+}
+
+const Sensor_Driver Sensor_ADC =
+{
+    "ADC",
+    SENSOR_CAP_VDD | SENSOR_CAP_CHIP | SENSOR_CAP_ANALOG,
+    ADC_CONV_MS,
+    0,
+    10,
+    ADC_SensorInit,
+    ADC_SensorStart,
+    ADC_SensorPoll,
+    ADC_SensorRead,
+};
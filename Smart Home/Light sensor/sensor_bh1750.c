@@ -0,0 +1,54 @@
+#include "sensor.h"
+#include "bh1750.h"
+
+// BH1750 光照传感器，挂在硬件 I2C1 上
+// 使用单次高分辨率模式：Start 发命令后传感器自行转换，期间总线空闲，
+// 不再像 BH1750_ReadLux 那样在驱动里 delay_ms(150)。
+#define SENSOR_BH1750_I2C      I2C1
+#define SENSOR_BH1750_CONV_MS  180   // 高分辨率模式最长测量时间（典型 120ms）
+
+static uint32_t StartTime;
+
+static SENSOR_STATUS BH1750_SensorInit(void)
+{
+    if (BH1750_Init(SENSOR_BH1750_I2C, BH1750_MODE_ONE_TIME_HIGH_RES_MODE) != BH1750_OK) return SENSOR_ERROR;
+    StartTime = Sensor_Now();
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS BH1750_SensorStart(void)
+{
+    // 单次模式测量完成后自动掉电，每次都要重新下发模式命令
+    if (BH1750_SetMode(SENSOR_BH1750_I2C, BH1750_MODE_ONE_TIME_HIGH_RES_MODE) != BH1750_OK) return SENSOR_ERROR;
+    StartTime = Sensor_Now();
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS BH1750_SensorPoll(void)
+{
+    return Sensor_Elapsed(StartTime, SENSOR_BH1750_CONV_MS) ? SENSOR_OK : SENSOR_BUSY;
+}
+
+static SENSOR_STATUS BH1750_SensorRead(Sensor_Data *data)
+{
+    uint8_t tmp[2];
+    if (I2C_ReadBytes_SPL(SENSOR_BH1750_I2C, BH1750_ADDRESS, tmp, 2) != BH1750_OK) return SENSOR_ERROR;
+
+    // lux = raw / 1.2，用整数运算代替浮点
+    data->Lux = ((uint32_t)((tmp[0] << 8) | tmp[1]) * 10) / 12;
+    data->Valid |= SENSOR_CAP_LUX;
+    return SENSOR_OK;
+}
+
+const Sensor_Driver Sensor_BH1750 =
+{
+    "BH1750",
+    SENSOR_CAP_LUX,
+    SENSOR_BH1750_CONV_MS,
+    0,
+    0,
+    BH1750_SensorInit,
+    BH1750_SensorStart,
+    BH1750_SensorPoll,
+    BH1750_SensorRead,
+};
@@ -0,0 +1,137 @@
+#include "sensor.h"
+#include "dht11.h"
+
+// DHT11 / DHT22(AM2302) 单总线温湿度传感器，共用 dht11.h 中定义的数据引脚
+// 两者位时序相同，只是起始信号长度和数据格式不同。
+// 单总线协议无法在后台转换：Read 本身要阻塞约 25ms 收 40 位数据，
+// Start 只检查距上次读取是否满足最小间隔。
+#define SENSOR_DHT11_PERIOD_MS  1000
+#define SENSOR_DHT22_PERIOD_MS  2000
+// Read 的阻塞时间：起始信号 + 响应 160us + 40 位（每位最长约 120us）约 5ms
+#define SENSOR_DHT11_READ_MS    26     // 起始信号 20ms
+#define SENSOR_DHT22_READ_MS    8      // 起始信号 2ms
+
+static uint32_t LastRead;
+static uint8_t  HasRead = 0;
+
+/* 读取 40 位原始数据并校验，StartLowMs 为主机拉低的时间 */
+static SENSOR_STATUS DHT_ReadFrame(uint8_t *buf, uint16_t StartLowMs)
+{
+    uint8_t i;
+
+    DHT11_Mode(OUT);
+    DHT11_Low;
+    delay_ms(StartLowMs);
+    DHT11_High;
+    delay_us(30);
+
+    LastRead = Sensor_Now();
+    HasRead = 1;
+    if (DHT11_Check() != 0) return SENSOR_ERROR;
+
+    for (i = 0; i < 5; i++)
+    {
+        buf[i] = DHT11_Read_Byte();
+    }
+    if ((uint8_t)(buf[0] + buf[1] + buf[2] + buf[3]) != buf[4]) return SENSOR_ERROR; // 校验失败
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS DHT_Start(uint16_t PeriodMs)
+{
+    if (HasRead && !Sensor_Elapsed(LastRead, PeriodMs)) return SENSOR_BUSY;
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS DHT_Poll(void)
+{
+    return SENSOR_OK; // 数据在 Read 时才传输
+}
+
+/* ------------------------------ DHT11 ------------------------------ */
+
+static SENSOR_STATUS DHT11_SensorInit(void)
+{
+    if (DHT11_Init() != 0) return SENSOR_ERROR;
+    LastRead = Sensor_Now();
+    HasRead = 1;
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS DHT11_SensorStart(void)
+{
+    return DHT_Start(SENSOR_DHT11_PERIOD_MS);
+}
+
+static SENSOR_STATUS DHT11_SensorRead(Sensor_Data *data)
+{
+    uint8_t buf[5];
+    if (DHT_ReadFrame(buf, 20) != SENSOR_OK) return SENSOR_ERROR; // DHT11 需拉低 18ms 以上
+
+    // buf[0]/buf[2] 为整数部分，buf[3] 为温度小数（新版 DHT11 才有，旧版恒为 0）
+    data->Humi = buf[0] * 10;
+    data->Temp = buf[2] * 10 + (buf[3] & 0x0F);
+    if (buf[3] & 0x80) data->Temp = -data->Temp;
+    data->Valid |= SENSOR_CAP_TEMP | SENSOR_CAP_HUMI;
+    return SENSOR_OK;
+}
+
+const Sensor_Driver Sensor_DHT11 =
+{
+    "DHT11",
+    SENSOR_CAP_TEMP | SENSOR_CAP_HUMI,
+    SENSOR_DHT11_READ_MS,
+    SENSOR_DHT11_PERIOD_MS,
+    10,
+    DHT11_SensorInit,
+    DHT11_SensorStart,
+    DHT_Poll,
+    DHT11_SensorRead,
+};
+
+/* ------------------------------ DHT22 ------------------------------ */
+
+static SENSOR_STATUS DHT22_SensorInit(void)
+{
+    uint8_t buf[5];
+    uint16_t ms;
+    DHT11_Init(); // 配置引脚；DHT11 的 20ms 起始信号超出 DHT22 规格，结果不用
+    // delay_ms 单次最多 1864ms（SysTick->LOAD 为 24 位），分段等待
+    for (ms = 0; ms < SENSOR_DHT22_PERIOD_MS; ms += 1000)
+    {
+        delay_ms(1000);
+    }
+    return DHT_ReadFrame(buf, 2);
+}
+
+static SENSOR_STATUS DHT22_SensorStart(void)
+{
+    return DHT_Start(SENSOR_DHT22_PERIOD_MS);
+}
+
+static SENSOR_STATUS DHT22_SensorRead(Sensor_Data *data)
+{
+    uint8_t buf[5];
+    uint16_t raw;
+    if (DHT_ReadFrame(buf, 2) != SENSOR_OK) return SENSOR_ERROR; // DHT22 拉低 1~10ms
+
+    // 16 位数据，单位 0.1，温度最高位为符号位
+    data->Humi = (buf[0] << 8) | buf[1];
+    raw = ((buf[2] & 0x7F) << 8) | buf[3];
+    data->Temp = (buf[2] & 0x80) ? -(int16_t)raw : (int16_t)raw;
+    data->Valid |= SENSOR_CAP_TEMP | SENSOR_CAP_HUMI;
+    return SENSOR_OK;
+}
+
+const Sensor_Driver Sensor_DHT22 =
+{
+    "DHT22",
+    SENSOR_CAP_TEMP | SENSOR_CAP_HUMI,
+    SENSOR_DHT22_READ_MS,
+    SENSOR_DHT22_PERIOD_MS,
+    1,
+    DHT22_SensorInit,
+    DHT22_SensorStart,
+    DHT_Poll,
+    DHT22_SensorRead,
+};
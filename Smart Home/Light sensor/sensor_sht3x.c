@@ -0,0 +1,93 @@
+#include "sensor.h"
+#include "bh1750.h"   // 复用 I2C_WriteBytes_SPL / I2C_ReadBytes_SPL（无应答或超时返回错误，不会卡死）
+#include "delay.h"
+
+// SHT30/31/35 温湿度传感器，与 BH1750 共用硬件 I2C1（PB6/PB7）
+// 单次测量、高重复性、不使用时钟延展：转换期间总线空闲，15ms 后直接读 6 字节。
+// 分辨率 0.01°C（这里输出 0.1°C），不受单总线 1~2s 采样间隔的限制。
+#define SENSOR_SHT3X_I2C      I2C1
+#define SHT3X_ADDRESS         (0x44 << 1)  // ADDR 引脚接地；接 VDD 时为 0x45
+#define SENSOR_SHT3X_CONV_MS  16           // 高重复性最长 15.5ms
+
+static uint32_t StartTime;
+
+/* 发送 16 位命令 */
+static SENSOR_STATUS SHT3x_WriteCmd(uint16_t cmd)
+{
+    uint8_t buf[2];
+    buf[0] = cmd >> 8;
+    buf[1] = cmd & 0xFF;
+    return I2C_WriteBytes_SPL(SENSOR_SHT3X_I2C, SHT3X_ADDRESS, buf, 2) == BH1750_OK ? SENSOR_OK : SENSOR_ERROR;
+}
+
+/* CRC-8，多项式 0x31，初值 0xFF */
+static uint8_t SHT3x_CRC(const uint8_t *data)
+{
+    uint8_t crc = 0xFF;
+    uint8_t i, j;
+    for (i = 0; i < 2; i++)
+    {
+        crc ^= data[i];
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* 确认器件存在：读状态寄存器，地址有应答且 CRC 正确才算检测到 */
+static SENSOR_STATUS SHT3x_SensorInit(void)
+{
+    uint8_t buf[3];
+
+    if (SHT3x_WriteCmd(0x30A2) != SENSOR_OK) return SENSOR_ERROR; // 软复位，器件不在时地址无应答
+    delay_ms(2);
+    if (SHT3x_WriteCmd(0xF32D) != SENSOR_OK) return SENSOR_ERROR; // 读状态寄存器
+    if (I2C_ReadBytes_SPL(SENSOR_SHT3X_I2C, SHT3X_ADDRESS, buf, 3) != BH1750_OK) return SENSOR_ERROR;
+    if (SHT3x_CRC(buf) != buf[2]) return SENSOR_ERROR;
+    StartTime = Sensor_Now();
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS SHT3x_SensorStart(void)
+{
+    if (SHT3x_WriteCmd(0x2400) != SENSOR_OK) return SENSOR_ERROR; // 单次测量，高重复性，无时钟延展
+    StartTime = Sensor_Now();
+    return SENSOR_OK;
+}
+
+static SENSOR_STATUS SHT3x_SensorPoll(void)
+{
+    return Sensor_Elapsed(StartTime, SENSOR_SHT3X_CONV_MS) ? SENSOR_OK : SENSOR_BUSY;
+}
+
+static SENSOR_STATUS SHT3x_SensorRead(Sensor_Data *data)
+{
+    uint8_t buf[6];
+    uint16_t raw;
+
+    if (I2C_ReadBytes_SPL(SENSOR_SHT3X_I2C, SHT3X_ADDRESS, buf, 6) != BH1750_OK) return SENSOR_ERROR;
+    if (SHT3x_CRC(&buf[0]) != buf[2] || SHT3x_CRC(&buf[3]) != buf[5]) return SENSOR_ERROR;
+
+    // T = -45 + 175 * raw / 65535，RH = 100 * raw / 65535，结果放大 10 倍
+    raw = (buf[0] << 8) | buf[1];
+    data->Temp = (int16_t)(((int32_t)raw * 1750) / 65535 - 450);
+    raw = (buf[3] << 8) | buf[4];
+    data->Humi = (uint16_t)(((uint32_t)raw * 1000) / 65535);
+    data->Valid |= SENSOR_CAP_TEMP | SENSOR_CAP_HUMI;
+    return SENSOR_OK;
+}
+
+const Sensor_Driver Sensor_SHT3x =
+{
+    "SHT3x",
+    SENSOR_CAP_TEMP | SENSOR_CAP_HUMI,
+    SENSOR_SHT3X_CONV_MS,
+    0,
+    1,
+    SHT3x_SensorInit,
+    SHT3x_SensorStart,
+    SHT3x_SensorPoll,
+    SHT3x_SensorRead,
+};
@@ -0,0 +1,57 @@
+#include "spsc_queue.h"
+#include <string.h>
+
+/* 初始化队列，size 必须为 2 的幂 */
+void SPSC_Init(SPSC_Queue *q, void *buf, uint16_t item_size, uint16_t size)
+{
+    q->Buf = (uint8_t *)buf;
+    q->ItemSize = item_size;
+    q->Size = size;
+    q->Head = 0;
+    q->Tail = 0;
+    q->HighWater = 0;
+    q->Pushed = 0;
+    q->Overflow = 0;
+}
+
+/* 入队，只能在生产者一侧调用 */
+u8 SPSC_Push(SPSC_Queue *q, const void *item)
+{
+    uint16_t head = q->Head;
+    uint16_t used = (uint16_t)(head - q->Tail);
+
+    if (used >= q->Size)
+    {
+        q->Overflow++;  // 满了直接丢弃，不等待
+        return 1;
+    }
+
+    memcpy(&q->Buf[(head & (q->Size - 1)) * q->ItemSize], item, q->ItemSize);
+    __DMB();            // 数据写完后再发布索引，消费者看到新 Head 时数据一定有效
+    q->Head = (uint16_t)(head + 1);
+
+    used++;
+    if (used > q->HighWater) q->HighWater = used;
+    q->Pushed++;
+    return 0;
+}
+
+/* 出队，只能在消费者一侧调用 */
+u8 SPSC_Pop(SPSC_Queue *q, void *item)
+{
+    uint16_t tail = q->Tail;
+
+    if (tail == q->Head) return 1;
+
+    __DMB();            // 先确认 Head 再读数据
+    memcpy(item, &q->Buf[(tail & (q->Size - 1)) * q->ItemSize], q->ItemSize);
+    __DMB();            // 数据读完后再释放槽位
+    q->Tail = (uint16_t)(tail + 1);
+    return 0;
+}
+
+/* 当前元素个数，两侧都可调用（结果是瞬时值） */
+uint16_t SPSC_Count(const SPSC_Queue *q)
+{
+    return (uint16_t)(q->Head - q->Tail);
+}
@@ -0,0 +1,29 @@
+#ifndef __SPSC_QUEUE_H
+#define __SPSC_QUEUE_H
+
+#include "stm32f10x.h"
+
+// 单生产者/单消费者无锁环形队列
+// 生产者（通常是中断）只写 Head，消费者（通常是主循环）只写 Tail，
+// Cortex-M3 上对齐的半字读写是原子的，只需在发布索引前加内存屏障，不用关中断。
+// 索引自由递增，Size 必须为 2 的幂（最大 32768），已用数量 = Head - Tail。
+typedef struct
+{
+    uint8_t *Buf;                // 存储区，大小 Size * ItemSize
+    uint16_t ItemSize;           // 每个元素的字节数
+    uint16_t Size;               // 元素个数，2 的幂
+    volatile uint16_t Head;      // 写索引（仅生产者修改）
+    volatile uint16_t Tail;      // 读索引（仅消费者修改）
+
+    // 统计信息，均由生产者更新
+    volatile uint16_t HighWater; // 历史最大占用
+    volatile uint32_t Pushed;    // 成功入队次数
+    volatile uint32_t Overflow;  // 队列满丢弃次数
+} SPSC_Queue;
+
+void SPSC_Init(SPSC_Queue *q, void *buf, uint16_t item_size, uint16_t size);
+u8 SPSC_Push(SPSC_Queue *q, const void *item); // 返回0:成功 1:队列满（计入 Overflow）
+u8 SPSC_Pop(SPSC_Queue *q, void *item);        // 返回0:成功 1:队列空
+uint16_t SPSC_Count(const SPSC_Queue *q);      // 当前元素个数
+
+#endif
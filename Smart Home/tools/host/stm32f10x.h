@@ -0,0 +1,102 @@
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+
+/* 主机（Linux/gcc）测试用的替身头文件，只提供被测模块用到的类型、常量和函数声明，
+ * 用 -I tools/host 代替 SPL 的 stm32f10x.h。外设函数由各测试程序自己实现，
+ * 例如 tools/rs485_host.c 用伪终端模拟 USART1。 */
+#include <stdint.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+
+#define __DMB()          __sync_synchronize()
+#define __disable_irq()  ((void)0)
+#define __enable_irq()   ((void)0)
+
+extern uint32_t SystemCoreClock;
+
+/* ------------------------------ GPIO ------------------------------ */
+typedef struct { uint32_t ODR; } GPIO_TypeDef;
+extern GPIO_TypeDef HostGPIOA;
+#define GPIOA  (&HostGPIOA)
+
+#define GPIO_Pin_8   ((uint16_t)0x0100)
+#define GPIO_Pin_9   ((uint16_t)0x0200)
+#define GPIO_Pin_10  ((uint16_t)0x0400)
+
+typedef enum { GPIO_Speed_10MHz = 1, GPIO_Speed_2MHz, GPIO_Speed_50MHz } GPIOSpeed_TypeDef;
+typedef enum
+{
+    GPIO_Mode_AIN = 0x0, GPIO_Mode_IN_FLOATING = 0x04, GPIO_Mode_IPD = 0x28, GPIO_Mode_IPU = 0x48,
+    GPIO_Mode_Out_OD = 0x14, GPIO_Mode_Out_PP = 0x10, GPIO_Mode_AF_OD = 0x1C, GPIO_Mode_AF_PP = 0x18
+} GPIOMode_TypeDef;
+
+typedef struct
+{
+    uint16_t GPIO_Pin;
+    GPIOSpeed_TypeDef GPIO_Speed;
+    GPIOMode_TypeDef GPIO_Mode;
+} GPIO_InitTypeDef;
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct);
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* ------------------------------ RCC ------------------------------- */
+#define RCC_APB2Periph_GPIOA   ((uint32_t)0x00000004)
+#define RCC_APB2Periph_USART1  ((uint32_t)0x00004000)
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState);
+
+/* ------------------------------ NVIC ------------------------------ */
+typedef enum { USART1_IRQn = 37, TIM2_IRQn = 28 } IRQn_Type;
+typedef struct
+{
+    uint8_t NVIC_IRQChannel;
+    uint8_t NVIC_IRQChannelPreemptionPriority;
+    uint8_t NVIC_IRQChannelSubPriority;
+    FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct);
+
+/* ------------------------------ USART ----------------------------- */
+typedef struct { uint32_t Dummy; } USART_TypeDef;
+extern USART_TypeDef HostUSART1;
+#define USART1  (&HostUSART1)
+
+#define USART_WordLength_8b              ((uint16_t)0x0000)
+#define USART_StopBits_1                 ((uint16_t)0x0000)
+#define USART_Parity_No                  ((uint16_t)0x0000)
+#define USART_Mode_Rx                    ((uint16_t)0x0004)
+#define USART_Mode_Tx                    ((uint16_t)0x0008)
+#define USART_HardwareFlowControl_None   ((uint16_t)0x0000)
+
+#define USART_IT_TXE    ((uint16_t)0x0727)
+#define USART_IT_TC     ((uint16_t)0x0626)
+#define USART_IT_RXNE   ((uint16_t)0x0525)
+#define USART_IT_IDLE   ((uint16_t)0x0424)
+#define USART_FLAG_ORE  ((uint16_t)0x0008)
+
+typedef struct
+{
+    uint32_t USART_BaudRate;
+    uint16_t USART_WordLength;
+    uint16_t USART_StopBits;
+    uint16_t USART_Parity;
+    uint16_t USART_Mode;
+    uint16_t USART_HardwareFlowControl;
+} USART_InitTypeDef;
+
+void USART_Init(USART_TypeDef *USARTx, USART_InitTypeDef *USART_InitStruct);
+void USART_Cmd(USART_TypeDef *USARTx, FunctionalState NewState);
+void USART_ITConfig(USART_TypeDef *USARTx, uint16_t USART_IT, FunctionalState NewState);
+ITStatus USART_GetITStatus(USART_TypeDef *USARTx, uint16_t USART_IT);
+FlagStatus USART_GetFlagStatus(USART_TypeDef *USARTx, uint16_t USART_FLAG);
+void USART_ClearITPendingBit(USART_TypeDef *USARTx, uint16_t USART_IT);
+void USART_SendData(USART_TypeDef *USARTx, uint16_t Data);
+uint16_t USART_ReceiveData(USART_TypeDef *USARTx);
+
+#endif
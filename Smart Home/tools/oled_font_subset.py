@@ -0,0 +1,298 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+OLED 字库裁剪工具（构建前步骤）
+
+扫描应用源码中传给 OLED_ShowString / OLED_UpdateLine / OLED_ShowChar / OLED_ShowNum /
+OLED_ShowChinese 的字符串和字模索引（以及 sprintf 格式串），只保留实际用到的
+字模后生成 OLED_Font_Subset.h。oled.c 默认包含该文件（定义 OLED_FONT_FULL 时才用完整的
+OLED_Font.h），字库里没有的字符会画成空格，所以改了显示字符串后必须重新生成。
+
+用法：
+    python3 oled_font_subset.py --font OLED_Font.h --out OLED_Font_Subset.h \
+        [--charset " 0123456789"] [--hz 0,1,2] [--format auto|packed|plain] main.c ...
+    python3 oled_font_subset.py --font OLED_Font.h --out OLED_Font_Subset.h --check main.c ...
+
+Keil 中填到 Options -> User -> Before Build/Rebuild，每次构建前重新生成；
+--check 不写文件，源码用到的字模在现有头文件中缺失时返回 1，可用于提交前检查。
+
+压缩格式（每个字模独立编码，便于随机访问）：
+    8x16 字模 : 2 字节掩码 + 非零列字节
+    16x16 汉字: 4 字节掩码 + 非零列字节
+    掩码小端存放，bit i = 1 表示原字模第 i 个字节非零。OLED_F8x16 里全零字节
+    占三成左右，而非零字节很少连续重复，所以这种格式比 RLE 更小；解码循环次数
+    固定（16/32 次），绘制时间不随字形变化。
+压缩要多一张偏移表和 oled.c 中的解码函数 OLED_UnpackGlyph，字模少时省下的字节
+可能还不够抵消。--format auto（默认）按“数据 + 偏移表 + 解码代码”与不压缩的裁剪字库
+比较，选较小的一种；解码代码大小取 --decoder-bytes，以 .map 文件中 OLED_UnpackGlyph
+的 Code 大小为准。
+"""
+
+import argparse
+import re
+import sys
+
+ASCII_FIRST = 0x20
+ASCII_GLYPH_BYTES = 16
+HZ_GLYPH_BYTES = 32
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def parse_table(text, name, glyph_bytes):
+    """从 OLED_Font.h 中取出指定数组，按字模大小切分"""
+    m = re.search(name + r"\s*\[\s*\]\s*\[\s*\d+\s*\]\s*=\s*\{(.*?)\}\s*;", text, re.S)
+    if not m:
+        sys.exit("找不到字模数组 %s" % name)
+    values = [int(v, 16) for v in re.findall(r"0[xX][0-9a-fA-F]+", strip_comments(m.group(1)))]
+    if len(values) % glyph_bytes:
+        sys.exit("%s 长度 %d 不是 %d 的整数倍" % (name, len(values), glyph_bytes))
+    return [values[i:i + glyph_bytes] for i in range(0, len(values), glyph_bytes)]
+
+
+def c_unescape(s):
+    return bytes(s, "utf-8").decode("unicode_escape")
+
+
+def scan_sources(paths):
+    """返回 (用到的 ASCII 字符集合, 用到的汉字索引集合)"""
+    chars = set()
+    hz = set()
+    for path in paths:
+        with open(path, encoding="utf-8", errors="ignore") as f:
+            text = strip_comments(f.read())
+
+        for s in re.findall(r"OLED_ShowString\s*\([^,]+,[^,]+,\s*\"((?:[^\"\\]|\\.)*)\"", text):
+            chars.update(c_unescape(s))
+        for s in re.findall(r"OLED_UpdateLine\s*\([^,]+,\s*\"((?:[^\"\\]|\\.)*)\"", text):
+            chars.update(c_unescape(s))
+        for s in re.findall(r"OLED_ShowChar\s*\([^,]+,[^,]+,\s*'((?:[^'\\]|\\.)+)'", text):
+            chars.update(c_unescape(s))
+
+        # sprintf 格式串：保留字面字符，数值转换按可能出现的字符展开
+        for s in re.findall(r"s?n?printf\s*\(\s*\w+\s*,(?:[^,]+,)?\s*\"((?:[^\"\\]|\\.)*)\"", text):
+            s = c_unescape(s)
+            for conv in re.findall(r"%[-+ #0]*\d*(?:\.\d+)?[hlL]*([diuxXcsf%])", s):
+                if conv in "diu":
+                    chars.update("0123456789-")
+                elif conv == "f":
+                    chars.update("0123456789-.")
+                elif conv in "xX":
+                    chars.update("0123456789abcdefABCDEF")
+                elif conv == "%":
+                    chars.add("%")
+            chars.update(re.sub(r"%[-+ #0]*\d*(?:\.\d+)?[hlL]*[diuxXcsf%]", "", s))
+
+        if re.search(r"OLED_Show(?:Num|SignedNum)\s*\(", text):
+            chars.update("0123456789+-")
+        if re.search(r"OLED_ShowHexNum\s*\(", text):
+            chars.update("0123456789ABCDEF")
+        if re.search(r"OLED_ShowBinNum\s*\(", text):
+            chars.update("01")
+
+        for n in re.findall(r"OLED_ShowChinese\s*\([^,]+,[^,]+,\s*(\d+)\s*\)", text):
+            hz.add(int(n))
+    return chars, hz
+
+
+def pack_glyph(glyph):
+    """列压缩：先写按位掩码（小端，bit i=1 表示第 i 列字节非零），再写非零字节"""
+    mask = 0
+    out = []
+    for i, b in enumerate(glyph):
+        if b:
+            mask |= 1 << i
+            out.append(b)
+    return list(mask.to_bytes(len(glyph) // 8, "little")) + out
+
+
+def unpack_glyph(data, size):
+    mask = int.from_bytes(bytes(data[:size // 8]), "little")
+    p = size // 8
+    out = []
+    for i in range(size):
+        if mask & (1 << i):
+            out.append(data[p])
+            p += 1
+        else:
+            out.append(0)
+    return out
+
+
+def emit_table(lines, ctype, name, values, per_line=16):
+    lines.append("const %s %s[%d]=" % (ctype, name, max(len(values), 1)))
+    lines.append("{")
+    if not values:
+        lines.append("\t0")
+    for i in range(0, len(values), per_line):
+        row = ",".join(("0x%02X" % v) if ctype == "uint8_t" else str(v) for v in values[i:i + per_line])
+        lines.append("\t" + row + ",")
+    lines.append("};")
+    lines.append("")
+
+
+def emit_glyphs(lines, name, glyphs, size):
+    """不压缩的字模表，每行一个字模"""
+    lines.append("const uint8_t %s[%d][%d]=" % (name, max(len(glyphs), 1), size))
+    lines.append("{")
+    if not glyphs:
+        lines.append("\t{0}")
+    for g in glyphs:
+        lines.append("\t{" + ",".join("0x%02X" % v for v in g) + "},")
+    lines.append("};")
+    lines.append("")
+
+
+def read_subset(path):
+    """读取现有 OLED_Font_Subset.h 中保留的字符和汉字索引，文件不存在返回 None"""
+    try:
+        with open(path, encoding="utf-8") as f:
+            text = f.read()
+    except OSError:
+        return None
+
+    def table(name):
+        m = re.search(name + r"\s*\[\s*\d+\s*\]\s*=\s*\{(.*?)\}\s*;", text, re.S)
+        return [int(v, 0) for v in re.findall(r"0[xX][0-9a-fA-F]+|\d+", m.group(1))] if m else []
+
+    count = re.search(r"OLED_SUBSET_HZ_NUM\s+(\d+)", text)
+    hz = table("OLED_SubsetHzIndex")[:int(count.group(1)) if count else 0]
+    return {chr(v) for v in table("OLED_SubsetChar")}, set(hz), text
+
+
+def main():
+    ap = argparse.ArgumentParser(description="裁剪并压缩 OLED 字库")
+    ap.add_argument("--font", required=True, help="原始 OLED_Font.h")
+    ap.add_argument("--out", required=True, help="生成的 OLED_Font_Subset.h")
+    ap.add_argument("--charset", default="", help="额外保留的 ASCII 字符")
+    ap.add_argument("--hz", default="", help="额外保留的汉字索引，逗号分隔")
+    ap.add_argument("--format", choices=("auto", "packed", "plain"), default="auto",
+                    help="字模存放格式，auto 按总大小（含解码代码）自动选择")
+    ap.add_argument("--decoder-bytes", type=int, default=64,
+                    help="OLED_UnpackGlyph 的代码大小，默认为 Cortex-M3 上的估计值，以 .map 为准")
+    ap.add_argument("--check", action="store_true", help="只检查 --out 是否包含源码用到的全部字模，不写文件")
+    ap.add_argument("sources", nargs="+", help="要扫描的应用源文件")
+    args = ap.parse_args()
+
+    with open(args.font, encoding="utf-8", errors="ignore") as f:
+        font_text = f.read()
+    ascii_table = parse_table(font_text, "OLED_F8x16", ASCII_GLYPH_BYTES)
+    hz_table = parse_table(font_text, "Hzk1", HZ_GLYPH_BYTES)
+
+    chars, hz = scan_sources(args.sources)
+    chars.update(c_unescape(args.charset))
+    chars.add(" ")  # 缺字时用空格代替，必须保留
+    hz.update(int(v) for v in args.hz.split(",") if v.strip())
+
+    chars = sorted(c for c in chars if ASCII_FIRST <= ord(c) < ASCII_FIRST + len(ascii_table))
+    hz = sorted(n for n in hz if n < len(hz_table))
+
+    if args.check:
+        current = read_subset(args.out)
+        if current is None:
+            sys.exit("%s 不存在，先运行生成" % args.out)
+        missing_chars = [c for c in chars if c not in current[0]]
+        missing_hz = [n for n in hz if n not in current[1]]
+        if missing_chars or missing_hz:
+            print("%s 缺少字模，这些字符会显示为空格：" % args.out)
+            if missing_chars:
+                print("  字符: %s" % "".join(missing_chars))
+            if missing_hz:
+                print("  汉字索引: %s" % ",".join(str(n) for n in missing_hz))
+            print("请重新运行本工具生成")
+            sys.exit(1)
+        print("%s 包含源码用到的全部字模" % args.out)
+        return
+
+    ascii_data, ascii_offset, ascii_stats = [], [], []
+    for c in chars:
+        glyph = ascii_table[ord(c) - ASCII_FIRST]
+        packed = pack_glyph(glyph)
+        assert unpack_glyph(packed, ASCII_GLYPH_BYTES) == glyph
+        ascii_offset.append(len(ascii_data))
+        ascii_data.extend(packed)
+        ascii_stats.append((repr(c), len(packed), ASCII_GLYPH_BYTES, len(packed) - ASCII_GLYPH_BYTES // 8))
+
+    hz_data, hz_offset, hz_stats = [], [], []
+    for n in hz:
+        glyph = hz_table[n]
+        packed = pack_glyph(glyph)
+        assert unpack_glyph(packed, HZ_GLYPH_BYTES) == glyph
+        hz_offset.append(len(hz_data))
+        hz_data.extend(packed)
+        hz_stats.append(("Hzk1[%d]" % n, len(packed), HZ_GLYPH_BYTES, len(packed) - HZ_GLYPH_BYTES // 8))
+
+    # 两种格式的 Flash 占用：字符表和汉字索引表两者都有，二分查找代码两者都有，不计
+    full = len(ascii_table) * ASCII_GLYPH_BYTES + len(hz_table) * HZ_GLYPH_BYTES
+    tables = len(chars) + len(hz)
+    plain_size = tables + len(chars) * ASCII_GLYPH_BYTES + len(hz) * HZ_GLYPH_BYTES
+    packed_data = len(ascii_offset) * 2 + len(ascii_data) + len(hz_offset) * 2 + len(hz_data)
+    packed_size = tables + packed_data + args.decoder_bytes
+    if args.format == "auto":
+        use_packed = packed_size < plain_size
+    else:
+        use_packed = args.format == "packed"
+
+    lines = [
+        "#ifndef __OLED_FONT_SUBSET_H",
+        "#define __OLED_FONT_SUBSET_H",
+        "",
+        "/* 由 tools/oled_font_subset.py 自动生成，请勿手工修改 */",
+        "/* 字符: %s */" % "".join(chars).replace("*/", "* /"),
+        "/* 汉字索引: %s */" % (",".join(str(n) for n in hz) or "无"),
+        "",
+        "#define OLED_SUBSET_CHAR_NUM    %d" % len(chars),
+        "#define OLED_SUBSET_HZ_NUM      %d" % len(hz),
+        "#define OLED_SUBSET_PACKED      %d   // 1: 列压缩，绘制时解压；0: 原始字模" % use_packed,
+        "",
+        "/*已保留的 ASCII 字符（升序，二分查找）*/",
+    ]
+    emit_table(lines, "uint8_t", "OLED_SubsetChar", [ord(c) for c in chars])
+    if use_packed:
+        lines.append("/*每个 ASCII 字模在 OLED_SubsetF8x16 中的起始偏移*/")
+        emit_table(lines, "uint16_t", "OLED_SubsetF8x16Offset", ascii_offset)
+        lines.append("/*列压缩后的 8x16 字模*/")
+        emit_table(lines, "uint8_t", "OLED_SubsetF8x16", ascii_data)
+    else:
+        lines.append("/*8x16 字模，与 OLED_SubsetChar 一一对应*/")
+        emit_glyphs(lines, "OLED_SubsetF8x16", [ascii_table[ord(c) - ASCII_FIRST] for c in chars], ASCII_GLYPH_BYTES)
+    lines.append("/*已保留的汉字在原 Hzk1 中的索引（升序）*/")
+    emit_table(lines, "uint8_t", "OLED_SubsetHzIndex", hz)
+    if use_packed:
+        lines.append("/*每个汉字字模在 OLED_SubsetHzk1 中的起始偏移*/")
+        emit_table(lines, "uint16_t", "OLED_SubsetHzk1Offset", hz_offset)
+        lines.append("/*列压缩后的 16x16 汉字字模*/")
+        emit_table(lines, "uint8_t", "OLED_SubsetHzk1", hz_data)
+    else:
+        lines.append("/*16x16 汉字字模，与 OLED_SubsetHzIndex 一一对应*/")
+        emit_glyphs(lines, "OLED_SubsetHzk1", [hz_table[n] for n in hz], HZ_GLYPH_BYTES)
+    lines.append("#endif")
+
+    with open(args.out, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(lines) + "\n")
+
+    # ---------------- 报告 ----------------
+    size = packed_size if use_packed else plain_size
+    print("原始字库        : %5d 字节 (%d 个 ASCII, %d 个汉字)" % (full, len(ascii_table), len(hz_table)))
+    print("裁剪不压缩      : %5d 字节 (%d 个 ASCII, %d 个汉字，含字符/索引表)" % (plain_size, len(chars), len(hz)))
+    print("裁剪+压缩       : %5d 字节 (数据和偏移表 %d + 解码代码约 %d + 字符/索引表 %d)" % (
+        packed_size, packed_data, args.decoder_bytes, tables))
+    print("压缩少用        : %5d 字节（负数表示压缩反而更大）" % (plain_size - packed_size))
+    print("选用格式        : %s" % ("列压缩" if use_packed else "不压缩"))
+    print("节省 Flash      : %5d 字节 (%.1f%%，相对原始字库)" % (full - size, 100.0 * (full - size) / full))
+    print("")
+    if use_packed:
+        print("逐字开销：解码固定 16/32 次循环，读取下列 Flash 字节；I2C 写入 16/32 字节与原来相同")
+    else:
+        print("逐字开销：只多一次二分查找，直接读取 16/32 字节；I2C 写入与原来相同")
+    print("板上实测周期数见 oled.c 中的 OLED_MeasureGlyphCycles()")
+    print("%-10s %6s %6s" % ("字模", "字节", "非零列"))
+    for name, packed, raw, nonzero in ascii_stats + hz_stats:
+        print("%-10s %6d %6d" % (name, packed if use_packed else raw, nonzero))
+
+
+if __name__ == "__main__":
+    main()
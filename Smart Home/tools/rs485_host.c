@@ -0,0 +1,385 @@
+/*
+ * rs485.c 的主机运行环境：把 USART1 映射到一个伪终端，直接运行固件里的帧格式、CRC、
+ * 接收状态机、从机应答和主机固定时隙轮询代码，由 rs485_sim.py --firmware 启动。
+ *
+ *     gcc -O2 -I tools/host -I "Light sensor" -o tools/rs485_host tools/rs485_host.c \
+ *         "Light sensor/rs485.c" "Light sensor/event_bus.c" "Light sensor/spsc_queue.c"
+ *
+ *     rs485_host --port /dev/pts/N --addr 3                                  从机
+ *     rs485_host --port /dev/pts/N --addr 0 --nodes 8 --cycles 20 [--offline 3,5]   主机
+ *
+ * 虚拟时钟：DWT_GetCycles() 返回虚拟时间，不读系统时钟。虚拟时间只在事件之间跳跃推进，
+ * 事件有主机的 1ms 节拍、发送结束（按 --baud 计算的线上时间）、收到的字节逐个到达、
+ * 一个字符无数据后的 IDLE，到期时按 USART1 的状态调用 USART1_IRQHandler（RXNE/IDLE/TXE/TC）。
+ * 收到的数据按线上时间排队：一串数据的第一个字节在对方等过 IDLE 之后开始，之后每字节
+ * 一个字符时间。主机发完请求后先按真实时间最多等 --grace-ms 让应答从别的进程到达，
+ * 这段时间虚拟时钟不走，所以伪终端转发和进程调度的延迟不会变成超时，只有掉线节点
+ * （或比 --grace-ms 还长的停顿）才会超时，结果可重复。
+ * DE 为高（本机在发送）期间到达的字节按 /RE 关闭处理丢弃，并记为一次总线冲突。
+ *
+ * 主机判定：数据错号、CRC 错误、掉线节点有应答都算失败；在线节点超时比例超过
+ * --max-timeout-pct（默认 0）也算失败。
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "rs485.h"
+#include "dwt.h"
+#include "event_bus.h"
+
+uint32_t SystemCoreClock = 72000000;
+GPIO_TypeDef HostGPIOA;
+USART_TypeDef HostUSART1;
+
+void USART1_IRQHandler(void);
+
+static int PortFd = -1;
+static uint8_t IsMaster;
+static double ByteUs = 86.8;          // 8N1 每字节 10 位
+static double IdleUs = 0;             // 判定总线空闲的时间，默认一个字符
+static int GraceMs = 100;             // 发完请求后按真实时间等应答的上限
+static double NowUs;                  // 虚拟时钟
+
+// USART1 状态
+static uint8_t ItRxne, ItIdle, ItTxe, ItTc;
+static uint8_t FlagRxne, FlagIdle, FlagTc = 1;
+static uint8_t Dr;
+static uint8_t RxFifo[512];
+static double RxAt[512];              // 每个字节在虚拟时钟上完整到达的时刻
+static uint16_t RxHead, RxTail;
+static uint8_t IdleArmed;
+static double LastRxUs;
+static double LineUs;                 // 总线上最近一个字节结束的时刻（收或发）
+static uint8_t TxWire[64];
+static uint8_t TxCount;
+static double TxStartUs;
+static uint8_t TxLoaded;              // 整帧已写入发送寄存器，等待线上时间结束
+static uint8_t DeHigh;
+static uint8_t InIsr;
+static uint8_t Expecting;             // 主机刚发完请求，应答可能还在伪终端里
+static uint32_t Collisions;
+static uint32_t MaxTimeoutPct = 0;
+
+#define HOST_NEVER 1e300
+
+/* 读入伪终端里的数据，按线上时间给每个字节标上到达时刻 */
+static void Host_Read(void)
+{
+    uint8_t buf[256];
+    double at;
+    ssize_t n, i;
+
+    n = read(PortFd, buf, sizeof(buf));
+    if (n <= 0) return;
+    if (RxTail != RxHead) at = RxAt[(uint16_t)(RxHead - 1) % sizeof(RxFifo)];  // 接在还没到达的数据后面
+    else at = (NowUs > LineUs + IdleUs) ? NowUs : LineUs + IdleUs;    // 对方等 IDLE 之后才开始发
+    for (i = 0; i < n; i++)
+    {
+        at += ByteUs;
+        RxAt[RxHead % sizeof(RxFifo)] = at;
+        RxFifo[RxHead++ % sizeof(RxFifo)] = buf[i];
+    }
+    Expecting = 0;
+}
+
+/* 处理虚拟时刻 NowUs 及之前到期的外设事件，需要时调用中断服务函数 */
+static void Host_Service(void)
+{
+    if (InIsr || PortFd < 0) return;
+    InIsr = 1;
+    Host_Read();
+
+    while (RxTail != RxHead && RxAt[RxTail % sizeof(RxFifo)] <= NowUs)
+    {
+        LastRxUs = LineUs = RxAt[RxTail % sizeof(RxFifo)];
+        Dr = RxFifo[RxTail++ % sizeof(RxFifo)];
+        if (DeHigh)
+        {
+            Collisions++;               // 本机正在驱动总线，/RE 关闭，收不到
+            continue;
+        }
+        IdleArmed = 1;
+        FlagRxne = 1;
+        if (ItRxne) USART1_IRQHandler();
+    }
+
+    if (IdleArmed && NowUs >= LastRxUs + IdleUs)
+    {
+        IdleArmed = 0;
+        FlagIdle = 1;
+        if (ItIdle) USART1_IRQHandler();
+    }
+
+    while (ItTxe && TxCount < sizeof(TxWire))
+    {
+        if (TxCount == 0) TxStartUs = NowUs;
+        USART1_IRQHandler();            // 每次 TXE 中断写入一个字节
+    }
+    if (TxCount && !ItTxe) TxLoaded = 1;
+
+    if (TxLoaded && NowUs >= TxStartUs + TxCount * ByteUs)
+    {
+        if (write(PortFd, TxWire, TxCount) < 0) perror("write");
+        LineUs = TxStartUs + TxCount * ByteUs;
+        TxCount = 0;
+        TxLoaded = 0;
+        FlagTc = 1;
+        Expecting = IsMaster;
+        if (ItTc) USART1_IRQHandler();
+    }
+    InIsr = 0;
+}
+
+/* 最近一个外设事件的虚拟时刻，没有时返回 HOST_NEVER */
+static double Host_NextEvent(void)
+{
+    double next = HOST_NEVER;
+
+    if (RxTail != RxHead) next = RxAt[RxTail % sizeof(RxFifo)];
+    if (IdleArmed && LastRxUs + IdleUs < next) next = LastRxUs + IdleUs;
+    if (TxLoaded && TxStartUs + TxCount * ByteUs < next) next = TxStartUs + TxCount * ByteUs;
+    return next;
+}
+
+/* 把虚拟时钟推进到 until 或更早的外设事件；没有事件可推进时按真实时间等伪终端 */
+static void Host_Advance(double until)
+{
+    struct pollfd pfd;
+    double next = Host_NextEvent();
+
+    pfd.fd = PortFd;
+    pfd.events = POLLIN;
+    if (Expecting)
+    {
+        // 应答在另一个进程里，先等它写进伪终端再让虚拟时间前进；等不到就是掉线节点
+        poll(&pfd, 1, GraceMs);
+        Expecting = 0;
+        Host_Service();
+        return;
+    }
+    if (next > until) next = until;
+    if (next == HOST_NEVER)
+    {
+        poll(&pfd, 1, -1);              // 从机：没有事件，等下一帧
+        Host_Service();
+        return;
+    }
+    NowUs = next;
+    Host_Service();
+}
+
+/* ------------------------------ 固件用到的外设函数 ------------------------------ */
+
+void DWT_Init(void) {}
+
+uint32_t DWT_GetCycles(void)
+{
+    return (uint32_t)(uint64_t)(NowUs * DWT_CYCLES_PER_US);
+}
+
+uint32_t DWT_CyclesToUs(uint32_t cycles)
+{
+    return cycles / DWT_CYCLES_PER_US;
+}
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct) { (void)GPIOx; (void)GPIO_InitStruct; }
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) { (void)RCC_APB2Periph; (void)NewState; }
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct) { (void)NVIC_InitStruct; }
+void USART_Init(USART_TypeDef *USARTx, USART_InitTypeDef *USART_InitStruct) { (void)USARTx; (void)USART_InitStruct; }
+void USART_Cmd(USART_TypeDef *USARTx, FunctionalState NewState) { (void)USARTx; (void)NewState; }
+
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR |= GPIO_Pin;
+    if (GPIOx == RS485_DE_GPIO_PORT && (GPIO_Pin & RS485_DE_GPIO_PIN)) DeHigh = 1;
+}
+
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR &= ~GPIO_Pin;
+    if (GPIOx == RS485_DE_GPIO_PORT && (GPIO_Pin & RS485_DE_GPIO_PIN)) DeHigh = 0;
+}
+
+void USART_ITConfig(USART_TypeDef *USARTx, uint16_t USART_IT, FunctionalState NewState)
+{
+    (void)USARTx;
+    switch (USART_IT)
+    {
+    case USART_IT_RXNE: ItRxne = NewState; break;
+    case USART_IT_IDLE: ItIdle = NewState; break;
+    case USART_IT_TXE:  ItTxe = NewState; break;
+    case USART_IT_TC:   ItTc = NewState; break;
+    }
+    if (!InIsr) Host_Service();         // 使能 TXE 后立即开始发送
+}
+
+ITStatus USART_GetITStatus(USART_TypeDef *USARTx, uint16_t USART_IT)
+{
+    (void)USARTx;
+    switch (USART_IT)
+    {
+    case USART_IT_RXNE: return (ItRxne && FlagRxne) ? SET : RESET;
+    case USART_IT_IDLE: return (ItIdle && FlagIdle) ? SET : RESET;
+    case USART_IT_TXE:  return ItTxe ? SET : RESET;      // 模拟的发送寄存器总是空的
+    case USART_IT_TC:   return (ItTc && FlagTc) ? SET : RESET;
+    }
+    return RESET;
+}
+
+FlagStatus USART_GetFlagStatus(USART_TypeDef *USARTx, uint16_t USART_FLAG)
+{
+    (void)USARTx;
+    (void)USART_FLAG;
+    return RESET;                       // 不模拟溢出
+}
+
+void USART_ClearITPendingBit(USART_TypeDef *USARTx, uint16_t USART_IT)
+{
+    (void)USARTx;
+    if (USART_IT == USART_IT_TC) FlagTc = 0;
+}
+
+void USART_SendData(USART_TypeDef *USARTx, uint16_t Data)
+{
+    (void)USARTx;
+    FlagTc = 0;                         // 写 DR 清除 TC
+    if (TxCount < sizeof(TxWire)) TxWire[TxCount++] = (uint8_t)Data;
+}
+
+uint16_t USART_ReceiveData(USART_TypeDef *USARTx)
+{
+    (void)USARTx;
+    FlagRxne = 0;
+    FlagIdle = 0;                       // 读 SR 后读 DR 清除 IDLE
+    return Dr;
+}
+
+/* ------------------------------ 主机/从机角色 ------------------------------ */
+
+static int Host_OpenPort(const char *path)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+    {
+        perror(path);
+        exit(2);
+    }
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+static int Host_RunSlave(uint8_t addr)
+{
+    Sensor_Data sample;
+
+    // 与 rs485_sim.py 的仿真从机相同的可区分读数，主机据此检查数据没有串号
+    memset(&sample, 0, sizeof(sample));
+    sample.Temp = 200 + addr;
+    sample.Humi = 500 + addr;
+    sample.Lux = 100 * addr;
+    sample.Valid = 0x07;
+    RS485_SlaveSetSample(&sample);
+
+    for (;;) Host_Advance(HOST_NEVER);
+    return 0;
+}
+
+static int Host_RunMaster(uint8_t nodes, uint32_t cycles, const uint8_t *offline)
+{
+    static Sensor_Data table[RS485_MAX_NODES];
+    const RS485_NodeStats *ns;
+    const RS485_BusStats *bs;
+    uint32_t c = 0, bad[RS485_MAX_NODES + 1] = {0};
+    uint8_t a, online, failed = 0;
+    double tick = 1000;
+
+    // 与 main.c 相同：每 1ms 调用一次 RS485_MasterTick，上一周期结束后立即开始下一周期
+    RS485_MasterStart(table, nodes);
+    while (c < cycles)
+    {
+        Host_Advance(tick);
+        if (NowUs < tick) continue;
+        tick += 1000;
+        if (!RS485_MasterTick(&online)) continue;
+        for (a = 1; a <= nodes; a++)
+        {
+            Sensor_Data *d = &table[a - 1];
+            if (d->Valid && (d->Temp != 200 + a || d->Humi != 500 + a || d->Lux != 100u * a || d->Valid != 0x07)) bad[a]++;
+        }
+        if (++c < cycles) RS485_MasterStart(table, nodes);
+    }
+
+    bs = RS485_GetBusStats();
+    printf("固件主机：节点 %d 个，周期 %u 次，时隙 %.1fms，超时 %.1fms\n", nodes, cycles,
+           RS485_SLOT_US / 1000.0, RS485_TIMEOUT_US / 1000.0);
+    printf("周期时间 ms : 最小 %.2f  最大 %.2f  （理论 %.2f）\n",
+           bs->MinCycleUs / 1000.0, bs->MaxCycleUs / 1000.0, nodes * RS485_SLOT_US / 1000.0);
+    printf("CRC 错误    : %u    总线冲突: %u\n", bs->CrcErrors, Collisions);
+    printf("\n%4s %6s %6s %6s %6s %10s %10s\n", "地址", "轮询", "成功", "超时", "错数", "最近延迟ms", "最大延迟ms");
+    for (a = 1; a <= nodes; a++)
+    {
+        ns = RS485_GetNodeStats(a);
+        printf("%4d %6u %6u %6u %6u %10.2f %10.2f\n", a, ns->Polls, ns->Ok, ns->Timeout, bad[a],
+               ns->LastLatencyUs / 1000.0, ns->MaxLatencyUs / 1000.0);
+        if (bad[a] || (offline[a] ? ns->Ok != 0 : ns->Timeout * 100 > ns->Polls * MaxTimeoutPct)) failed++;
+    }
+    printf("\n结果: ");
+    if (failed == 0 && bs->CrcErrors == 0) printf("通过\n");
+    else printf("%d 个节点异常\n", failed);
+    return (failed || bs->CrcErrors) ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *port = 0;
+    int addr = -1, nodes = 8, i;
+    uint32_t cycles = 20;
+    uint8_t offline[RS485_MAX_NODES + 1] = {0};
+    char *p;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--port") && i + 1 < argc) port = argv[++i];
+        else if (!strcmp(argv[i], "--addr") && i + 1 < argc) addr = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--nodes") && i + 1 < argc) nodes = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--cycles") && i + 1 < argc) cycles = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--baud") && i + 1 < argc) ByteUs = 10e6 / atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--idle-us") && i + 1 < argc) IdleUs = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--max-timeout-pct") && i + 1 < argc) MaxTimeoutPct = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--grace-ms") && i + 1 < argc) GraceMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--offline") && i + 1 < argc)
+        {
+            for (p = strtok(argv[++i], ","); p; p = strtok(0, ","))
+            {
+                if (atoi(p) > 0 && atoi(p) <= RS485_MAX_NODES) offline[atoi(p)] = 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "用法: %s --port PTY --addr N [--nodes N --cycles N --offline a,b --baud B --idle-us US --max-timeout-pct P --grace-ms MS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!port || addr < 0 || addr > RS485_MAX_NODES) return 2;
+    if (nodes < 1) nodes = 1;
+    if (nodes > RS485_MAX_NODES) nodes = RS485_MAX_NODES;
+    if (IdleUs < ByteUs) IdleUs = ByteUs;   // 硬件 IDLE 在一个字符时间无数据后置位
+
+    PortFd = Host_OpenPort(port);
+    IsMaster = (addr == 0);
+    EventBus_Init();
+    RS485_Init((uint8_t)addr);
+    setvbuf(stdout, 0, _IOLBF, 0);
+
+    return addr ? Host_RunSlave((uint8_t)addr) : Host_RunMaster((uint8_t)nodes, cycles, offline);
+}
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+RS-485 多机总线 Linux 仿真（伪终端）
+
+用一组伪终端模拟一条半双工总线：集线器线程把任一端写入的字节转发给其他所有端，
+每个从机和主机各占一个伪终端，帧格式、CRC 和默认时隙/超时与 Light sensor/rs485.c 相同。
+
+    python3 rs485_sim.py --nodes 32 --cycles 50
+    python3 rs485_sim.py --nodes 8 --offline 3,5        # 模拟掉线节点
+    python3 rs485_sim.py --nodes 8 --external-master    # 只起从机，打印主机端口给外部程序使用
+
+--firmware 用 rs485_host（见 rs485_host.c）运行固件 rs485.c 本身，测试的是真实的 CRC、
+接收状态机、从机 IDLE 应答和主机时隙代码，而不是这里的 Python 实现：
+
+    gcc -O2 -I tools/host -I "Light sensor" -o tools/rs485_host tools/rs485_host.c \
+        "Light sensor/rs485.c" "Light sensor/event_bus.c" "Light sensor/spsc_queue.c"
+    python3 rs485_sim.py --nodes 8 --firmware both      # 固件主机 + 固件从机
+    python3 rs485_sim.py --nodes 8 --firmware slaves    # Python 主机 + 固件从机
+    python3 rs485_sim.py --nodes 8 --firmware master    # 固件主机 + Python 从机
+
+固件主机的时隙和超时是编译期常量 RS485_SLOT_US / RS485_TIMEOUT_US，--slot-ms/--timeout-ms 对它无效。
+
+虚拟时钟：伪终端没有波特率，也不能用真实时间判断超时（单核机器上伪终端转发和线程切换
+就要 0.3~0.5ms，而 115200 下请求加应答的线上时间约 1.74ms，离 2.5ms 超时只剩约 0.76ms）。
+所以主机（Python 主机和 rs485_host 里的固件主机）都用虚拟时钟：请求和应答的线上时间按
+--baud 和字节数计算，真实时间只用来等应答从别的线程或进程到达，最多等 --grace-ms，
+等不到才算掉线。结果可重复，调度抖动不会造成超时；实际周期以板上 RS485_GetBusStats() 为准。
+
+判定：数据错号、CRC 错误、掉线节点有应答、在线节点超时比例超过 --max-timeout-pct
+（默认 0）都算失败。
+"""
+
+import argparse
+import os
+import select
+import struct
+import subprocess
+import threading
+import time
+import tty
+
+CMD_READ = 0x01
+SAMPLE_FMT = "<hHIB"           # Temp(0.1°C) Humi(0.1%) Lux(lx) Valid
+SAMPLE_LEN = struct.calcsize(SAMPLE_FMT)
+MAX_DATA = 16
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def build_frame(addr, cmd, payload=b""):
+    body = bytes([addr, cmd, len(payload)]) + payload
+    return body + struct.pack("<H", crc16(body))
+
+
+class FrameParser:
+    """与 rs485.c 相同的接收状态机，idle 秒无数据时丢弃半帧"""
+
+    def __init__(self, idle):
+        self.buf = bytearray()
+        self.idle = idle
+        self.last = 0.0
+        self.crc_errors = 0
+
+    def feed(self, data):
+        now = time.monotonic()
+        if self.buf and now - self.last > self.idle:
+            self.buf.clear()
+        self.last = now
+        frames = []
+        for b in data:
+            self.buf.append(b)
+            if len(self.buf) >= 3:
+                if self.buf[2] > MAX_DATA:
+                    self.buf.clear()
+                    continue
+                if len(self.buf) == 5 + self.buf[2]:
+                    frame = bytes(self.buf)
+                    self.buf.clear()
+                    if crc16(frame[:-2]) == struct.unpack("<H", frame[-2:])[0]:
+                        frames.append((frame[0], frame[1], frame[3:-2]))
+                    else:
+                        self.crc_errors += 1
+        return frames
+
+
+def open_pty():
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    return master, slave
+
+
+def hub(fds, stop):
+    """总线：任一端写入的数据转发给其他所有端"""
+    while not stop.is_set():
+        ready, _, _ = select.select(fds, [], [], 0.05)
+        for fd in ready:
+            try:
+                data = os.read(fd, 256)
+            except OSError:
+                continue
+            for other in fds:
+                if other != fd:
+                    os.write(other, data)
+
+
+def slaves(ports, stop):
+    """所有仿真从机在同一个线程里运行（ports 为 {fd: 地址}），收到请求立即应答，
+    线上时间由主机的虚拟时钟计算"""
+    parsers = {fd: FrameParser(idle=0.002) for fd in ports}
+    while not stop.is_set():
+        ready, _, _ = select.select(list(ports), [], [], 0.05)
+        for fd in ready:
+            addr = ports[fd]
+            for a, cmd, _ in parsers[fd].feed(os.read(fd, 256)):
+                if a == addr and cmd == CMD_READ:
+                    # 每个节点给出可区分的读数，便于检查数据没有串号
+                    sample = struct.pack(SAMPLE_FMT, 200 + addr, 500 + addr, 100 * addr, 0x07)
+                    os.write(fd, build_frame(addr, CMD_READ | 0x80, sample))
+
+
+def master(fd, nodes, cycles, slot, timeout, byte_time, grace):
+    """固定时隙轮询，时间用虚拟时钟：应答延迟 = 请求 + 空闲 1 字符 + 应答的线上时间，
+    真实时间只用于等应答到达（最多 grace 秒）"""
+    parser = FrameParser(idle=0.002)
+    stats = {a: {"polls": 0, "ok": 0, "timeout": 0, "bad": 0, "lat": []} for a in range(1, nodes + 1)}
+    cycle_times = []
+    request = len(build_frame(1, CMD_READ))
+    now = 0.0
+
+    for _ in range(cycles):
+        cycle_start = now
+        for addr in range(1, nodes + 1):
+            s = stats[addr]
+            s["polls"] += 1
+            os.write(fd, build_frame(addr, CMD_READ))
+            got = None
+            deadline = time.monotonic() + grace
+            while got is None:
+                left = deadline - time.monotonic()
+                if left <= 0:
+                    break
+                ready, _, _ = select.select([fd], [], [], left)
+                if not ready:
+                    break
+                for a, cmd, payload in parser.feed(os.read(fd, 256)):
+                    if a == addr and cmd == CMD_READ | 0x80 and len(payload) == SAMPLE_LEN:
+                        got = struct.unpack(SAMPLE_FMT, payload)
+                        latency = (request + 1 + 5 + len(payload)) * byte_time
+            if got is None or latency >= timeout:
+                s["timeout"] += 1
+            else:
+                s["lat"].append(latency)
+                if got != (200 + addr, 500 + addr, 100 * addr, 0x07):
+                    s["bad"] += 1
+                else:
+                    s["ok"] += 1
+            now += slot   # 固定时隙
+        cycle_times.append(now - cycle_start)
+    return stats, cycle_times, parser.crc_errors
+
+
+def main():
+    ap = argparse.ArgumentParser(description="RS-485 多机轮询仿真")
+    ap.add_argument("--nodes", type=int, default=32, help="从机数量（地址 1~N，最多 32）")
+    ap.add_argument("--cycles", type=int, default=20, help="主机轮询周期数")
+    ap.add_argument("--slot-ms", type=float, default=3.0, help="每个从机的时隙（RS485_SLOT_US）")
+    ap.add_argument("--timeout-ms", type=float, default=2.5, help="等待应答超时（RS485_TIMEOUT_US）")
+    ap.add_argument("--baud", type=int, default=115200, help="模拟波特率，0 表示不加传输时间")
+    ap.add_argument("--offline", default="", help="不启动的从机地址，逗号分隔")
+    ap.add_argument("--external-master", action="store_true", help="不运行仿真主机，打印主机端口后等待")
+    ap.add_argument("--firmware", choices=("none", "slaves", "master", "both"), default="none",
+                    help="哪些节点运行固件 rs485.c（需要先编译 rs485_host）")
+    ap.add_argument("--host-bin", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "rs485_host"),
+                    help="rs485_host 可执行文件")
+    ap.add_argument("--max-timeout-pct", type=int, default=0,
+                    help="允许的在线节点超时比例")
+    ap.add_argument("--grace-ms", type=int, default=100,
+                    help="主机发出请求后按真实时间等应答的上限，超过才算超时")
+    args = ap.parse_args()
+    fw_slaves = args.firmware in ("slaves", "both")
+    fw_master = args.firmware in ("master", "both")
+    if (fw_slaves or fw_master) and not os.access(args.host_bin, os.X_OK):
+        raise SystemExit("找不到 %s，先按文件开头的命令编译 rs485_host" % args.host_bin)
+
+    nodes = min(max(args.nodes, 1), 32)
+    offline = {int(v) for v in args.offline.split(",") if v.strip()}
+    byte_time = 10.0 / args.baud if args.baud else 0.0   # 8N1 每字节 10 位
+
+    stop = threading.Event()
+    hub_fds = []
+    threads = []
+    procs = []
+    sim_ports = {}
+
+    master_hub, master_fd = open_pty()
+    hub_fds.append(master_hub)
+    for addr in range(1, nodes + 1):
+        h, fd = open_pty()
+        hub_fds.append(h)
+        if addr in offline:
+            continue
+        if fw_slaves:
+            procs.append(subprocess.Popen([args.host_bin, "--port", os.ttyname(fd), "--addr", str(addr),
+                                           "--baud", str(args.baud or 1000000)]))
+        else:
+            sim_ports[fd] = addr
+    if sim_ports:
+        threads.append(threading.Thread(target=slaves, args=(sim_ports, stop), daemon=True))
+    threads.append(threading.Thread(target=hub, args=(hub_fds, stop), daemon=True))
+    for t in threads:
+        t.start()
+
+    def cleanup():
+        stop.set()
+        for p in procs:
+            p.terminate()
+            p.wait()
+
+    if args.external_master:
+        print("主机端口: %s（Ctrl+C 退出）" % os.ttyname(master_fd))
+        try:
+            while True:
+                time.sleep(1)
+        except KeyboardInterrupt:
+            pass
+        cleanup()
+        return
+
+    if fw_master:
+        time.sleep(0.2)   # 等从机进程打开端口
+        cmd = [args.host_bin, "--port", os.ttyname(master_fd), "--addr", "0", "--nodes", str(nodes),
+               "--cycles", str(args.cycles), "--baud", str(args.baud or 1000000),
+               "--max-timeout-pct", str(args.max_timeout_pct), "--grace-ms", str(args.grace_ms)]
+        if offline:
+            cmd += ["--offline", ",".join(str(a) for a in sorted(offline))]
+        code = subprocess.call(cmd)
+        cleanup()
+        raise SystemExit(code)
+
+    if fw_slaves:
+        time.sleep(0.2)
+
+    stats, cycle_times, crc_errors = master(master_fd, nodes, args.cycles,
+                                           args.slot_ms / 1000.0, args.timeout_ms / 1000.0, byte_time,
+                                           args.grace_ms / 1000.0)
+    cleanup()
+
+    avg_cycle = sum(cycle_times) / len(cycle_times)
+    print("节点 %d 个，周期 %d 次，时隙 %.1fms" % (nodes, args.cycles, args.slot_ms))
+    print("周期时间 ms : 最小 %.2f  平均 %.2f  最大 %.2f  （理论 %.2f）" % (
+        min(cycle_times) * 1000, avg_cycle * 1000, max(cycle_times) * 1000, nodes * args.slot_ms))
+    print("CRC 错误    : %d" % crc_errors)
+    if byte_time:
+        req = len(build_frame(1, CMD_READ))
+        ack = len(build_frame(1, CMD_READ | 0x80, bytes(SAMPLE_LEN)))
+        print("理论延迟 ms : %.2f  （请求 %d 字节 + 空闲 1 字符 + 应答 %d 字节，超时 %.2f）" % (
+            (req + 1 + ack) * byte_time * 1000, req, ack, args.timeout_ms))
+    print("")
+    print("%4s %6s %6s %6s %6s %10s %10s %10s" % ("地址", "轮询", "成功", "超时", "错数", "平均延迟ms", "最大延迟ms", "吞吐B/s"))
+    failed = 0
+    for addr in range(1, nodes + 1):
+        s = stats[addr]
+        lat = s["lat"]
+        throughput = SAMPLE_LEN * s["ok"] / s["polls"] / avg_cycle
+        print("%4d %6d %6d %6d %6d %10.2f %10.2f %10.1f" % (
+            addr, s["polls"], s["ok"], s["timeout"], s["bad"],
+            (sum(lat) / len(lat) * 1000) if lat else 0.0, (max(lat) * 1000) if lat else 0.0, throughput))
+        if addr in offline:
+            lost = s["ok"] != 0
+        else:
+            lost = s["timeout"] * 100 > s["polls"] * args.max_timeout_pct
+        if lost or s["bad"]:
+            failed += 1
+    print("")
+    print("结果: %s" % ("通过" if failed == 0 and crc_errors == 0 else "%d 个节点异常" % failed))
+    raise SystemExit(1 if failed or crc_errors else 0)
+
+
+if __name__ == "__main__":
+    main()
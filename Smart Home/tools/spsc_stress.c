@@ -0,0 +1,149 @@
+/*
+ * SPSC 队列主机压力测试：一个生产者线程、一个消费者线程，直接编译固件里的 spsc_queue.c
+ *
+ *     gcc -O2 -pthread -I tools/host -I "Light sensor" \
+ *         tools/spsc_stress.c "Light sensor/spsc_queue.c" -o spsc_stress
+ *     ./spsc_stress [元素个数，默认 2000000]
+ *
+ * 检查项：
+ *   1. 顺序和完整性：消费者收到的序号必须连续，元素内容不能被撕裂（带反码校验）
+ *   2. 统计：Pushed 等于成功入队数，Overflow 等于生产者看到的失败次数，
+ *      HighWater 不超过容量；单线程阶段的 HighWater/Overflow 为确定值
+ *   3. 16 位索引回绕：元素个数远大于 65536
+ * 生产者遇到队列满时重试，所以满队列和 Overflow 计数都会被覆盖到。
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "spsc_queue.h"
+
+#define QUEUE_SIZE  16
+
+typedef struct
+{
+    uint32_t Seq;
+    uint32_t Check;    // ~Seq，读到一半被覆盖时对不上
+} Item;
+
+static SPSC_Queue Queue;
+static Item QueueBuf[QUEUE_SIZE];
+static uint32_t Total;
+static uint32_t ProducerFull;    // 生产者看到的队列满次数
+static volatile int ProducerDone;
+
+static int Failures;
+
+static void check(int cond, const char *what)
+{
+    if (!cond)
+    {
+        printf("失败: %s\n", what);
+        Failures++;
+    }
+}
+
+/* 单线程：填满再多推 3 个，统计必须是确定值 */
+static void test_single_thread(void)
+{
+    Item item;
+    uint32_t i;
+
+    SPSC_Init(&Queue, QueueBuf, sizeof(Item), QUEUE_SIZE);
+    for (i = 0; i < QUEUE_SIZE + 3; i++)
+    {
+        item.Seq = i;
+        item.Check = ~i;
+        check(SPSC_Push(&Queue, &item) == (i < QUEUE_SIZE ? 0 : 1), "满队列时 Push 返回值");
+    }
+    check(SPSC_Count(&Queue) == QUEUE_SIZE, "满队列 Count");
+    check(Queue.HighWater == QUEUE_SIZE, "满队列 HighWater");
+    check(Queue.Overflow == 3, "满队列 Overflow");
+    check(Queue.Pushed == QUEUE_SIZE, "满队列 Pushed");
+
+    for (i = 0; i < QUEUE_SIZE; i++)
+    {
+        check(SPSC_Pop(&Queue, &item) == 0 && item.Seq == i && item.Check == ~i, "单线程出队顺序");
+    }
+    check(SPSC_Pop(&Queue, &item) == 1, "空队列 Pop 返回值");
+    check(Queue.HighWater == QUEUE_SIZE, "出队后 HighWater 保持");
+}
+
+static void *producer(void *arg)
+{
+    Item item;
+    uint32_t seq = 0;
+
+    (void)arg;
+    while (seq < Total)
+    {
+        item.Seq = seq;
+        item.Check = ~seq;
+        if (SPSC_Push(&Queue, &item) == 0)
+        {
+            seq++;
+        }
+        else
+        {
+            ProducerFull++;
+            sched_yield();
+        }
+    }
+    ProducerDone = 1;
+    return 0;
+}
+
+/* 两个线程：消费者每 64 个元素让出一次 CPU，让队列经常处于满和空两种状态 */
+static void test_two_threads(void)
+{
+    pthread_t thread;
+    Item item;
+    uint32_t expect = 0;
+    uint32_t reorder = 0, torn = 0;
+
+    SPSC_Init(&Queue, QueueBuf, sizeof(Item), QUEUE_SIZE);
+    ProducerFull = 0;
+    ProducerDone = 0;
+    pthread_create(&thread, 0, producer, 0);
+
+    for (;;)
+    {
+        if (SPSC_Pop(&Queue, &item) == 0)
+        {
+            if (item.Check != ~item.Seq) torn++;
+            if (item.Seq != expect) reorder++;
+            expect = item.Seq + 1;
+            if ((expect & 63) == 0) sched_yield();
+        }
+        else if (ProducerDone && SPSC_Count(&Queue) == 0)
+        {
+            break;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    pthread_join(thread, 0);
+
+    printf("元素 %u，乱序 %u，撕裂 %u，Pushed %u，Overflow %u（生产者看到 %u），HighWater %u/%d\n",
+           expect, reorder, torn, Queue.Pushed, Queue.Overflow, ProducerFull, Queue.HighWater, QUEUE_SIZE);
+    check(expect == Total, "收到的元素个数");
+    check(reorder == 0, "顺序");
+    check(torn == 0, "元素完整");
+    check(Queue.Pushed == Total, "Pushed 等于成功入队数");
+    check(Queue.Overflow == ProducerFull, "Overflow 等于生产者看到的满次数");
+    check(Queue.HighWater >= 1 && Queue.HighWater <= QUEUE_SIZE, "HighWater 范围");
+    check(ProducerFull == 0 || Queue.HighWater == QUEUE_SIZE, "出现过满队列时 HighWater 等于容量");
+}
+
+int main(int argc, char **argv)
+{
+    Total = argc > 1 ? (uint32_t)strtoul(argv[1], 0, 0) : 2000000;
+
+    test_single_thread();
+    test_two_threads();
+
+    printf("结果: %s\n", Failures ? "失败" : "通过");
+    return Failures ? 1 : 0;
+}